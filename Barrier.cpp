@@ -0,0 +1,25 @@
+//
+// Reusable barrier for the host threads of a multicore run.
+//
+
+#include "Barrier.h"
+
+Barrier::Barrier(int THREADS, std::function<void()> COMPLETION){
+    threads = THREADS;
+    waiting = 0;
+    generation = 0;
+    completion = COMPLETION;
+}
+void Barrier::wait(){
+    std::unique_lock<std::mutex> guard(lock);
+    unsigned long long arrived = generation;
+    if(++waiting == threads){
+        if(completion)
+            completion();
+        waiting = 0;
+        generation++;
+        released.notify_all();
+        return;
+    }
+    released.wait(guard, [this, arrived]{ return generation != arrived; });
+}
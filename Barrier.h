@@ -0,0 +1,27 @@
+//
+// Reusable barrier for the host threads of a multicore run.
+//
+
+#ifndef TOMASULO_BARRIER_H
+#define TOMASULO_BARRIER_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+class Barrier {
+    private:
+        std::mutex lock;
+        std::condition_variable released;
+        int threads;
+        int waiting;
+        unsigned long long generation;
+        // run by the last thread to arrive, before any are released
+        std::function<void()> completion;
+    //**** Methods
+    public:
+        Barrier(int threads, std::function<void()> completion);
+        void wait();
+};
+
+#endif //TOMASULO_BARRIER_H
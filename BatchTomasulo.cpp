@@ -0,0 +1,255 @@
+//
+// Batched timing model: K architectures of the same program advanced
+// together, one lane per architecture.
+//
+// The program has no branches and register values never change the
+// timing, so every lane sees the same instruction stream and only the
+// tags, latency counters and busy/ready flags differ. Those live in
+// [station][lane] arrays and EXECUTE/WRITEBACK are branch free loops
+// over the lanes, which the compiler turns into SIMD code. Stations are
+// numbered with each class padded to the largest count of any lane;
+// since ISSUE takes the first free station of a class the timing is the
+// same as a Tomasulo machine with that lane's architecture.
+// (#pragma GCC ivdep: the per-station rows never overlap.)
+//
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "BatchTomasulo.h"
+#include "Profile.h"
+#include "Tomasulo.h"       // ISSUE_Lat, WRITEBACK_Lat
+
+using namespace std;
+
+BatchConfig::BatchConfig(){
+    numRS[0] = 4;
+    numRS[1] = 2;
+    numRS[2] = 3;
+    lat[0] = 4;
+    lat[1] = 12;
+    lat[2] = 38;
+}
+BatchConfig::BatchConfig(int numAdd, int numMult, int numDiv,
+                         int addLat, int multLat, int divLat){
+    numRS[0] = numAdd;
+    numRS[1] = numMult;
+    numRS[2] = numDiv;
+    lat[0] = addLat;
+    lat[1] = multLat;
+    lat[2] = divLat;
+}
+
+// Every lane starts with F0..F(numRegisters-1) ready and empty
+// stations. The stations of all lanes together (largest count of
+// each class) must not exceed BatchMaxStations.
+BatchTomasulo::BatchTomasulo(const vector<BatchConfig>& CONFIG,
+                             const vector<Instruction>& PROGRAM, int numRegisters){
+    Config = CONFIG;
+    lanes = CONFIG.size();
+    paddedLanes = (lanes + BatchLaneAlign-1)/BatchLaneAlign*BatchLaneAlign;
+    const int K = paddedLanes;
+    Clock = 0;
+    doneClock.assign(lanes, 0);
+
+    S = 0;
+    for(int c=0;c<3;c++){
+        maxRS[c] = 0;
+        for(int k=0;k<lanes;k++)
+            if(CONFIG[k].numRS[c] > maxRS[c])
+                maxRS[c] = CONFIG[k].numRS[c];
+        classStart[c] = S;
+        S += maxRS[c];
+    }
+
+    int N = PROGRAM.size();
+    rd.resize(N);
+    rs.resize(N);
+    rt.resize(N);
+    cls.resize(N);
+    for(int i=0;i<N;i++){
+        rd[i] = PROGRAM[i].rd;
+        rs[i] = PROGRAM[i].rs;
+        rt[i] = PROGRAM[i].rt;
+        cls[i] = PROGRAM[i].op == MultOp ? 1 : PROGRAM[i].op == DivOp ? 2 : 0;
+    }
+
+    // padding lanes have no stations and nothing to run
+    currentInst_ISSUE.assign(K, N);
+    Total_WRITEBACKS.assign(K, N);
+    for(int c=0;c<3;c++){
+        numRS[c].assign(K, 0);
+        classLat[c].assign(K, 1);
+    }
+    for(int k=0;k<lanes;k++){
+        currentInst_ISSUE[k] = 0;
+        Total_WRITEBACKS[k] = 0;
+        for(int c=0;c<3;c++){
+            numRS[c][k] = CONFIG[k].numRS[c];
+            classLat[c][k] = CONFIG[k].lat[c];
+        }
+    }
+    busy.assign(S*K, 0);
+    lat.assign(S*K, 0);
+    resultReady.assign(S*K, 0);
+    issueLat.assign(S*K, 0);
+    writebackLat.assign(S*K, 0);
+    Qj.assign(S*K, 0);
+    Qk.assign(S*K, 0);
+    Qi.assign(numRegisters*K, 0);
+    chosen.resize(K);
+    issueClass.resize(K);
+    wbMask.resize(K);
+}
+void BatchTomasulo::cycle(){
+    Clock++;
+    ISSUE();
+    EXECUTE();
+    WRITEBACK();
+    int N = rd.size();
+    for(int k=0;k<lanes;k++)
+        if(doneClock[k] == 0 && currentInst_ISSUE[k] == N && Total_WRITEBACKS[k] == N)
+            doneClock[k] = Clock;
+}
+bool BatchTomasulo::done(){
+    for(int k=0;k<lanes;k++)
+        if(doneClock[k] == 0)
+            return false;
+    return true;
+}
+
+int readBatchConfigs(const char* path, vector<BatchConfig>& CONFIG){
+    ifstream in(path);
+    if(!in.is_open())
+        return -1;
+    string text;
+    int line = 0;
+    while(getline(in, text)){
+        line++;
+        // strip comments and skip blank lines
+        size_t comment = text.find("//");
+        if(comment != string::npos)
+            text.erase(comment);
+        comment = text.find('#');
+        if(comment != string::npos)
+            text.erase(comment);
+        if(text.find_first_not_of(" \t\r") == string::npos)
+            continue;
+        BatchConfig C;
+        if(sscanf(text.c_str(), " %d,%d,%d %d,%d,%d", &C.numRS[0], &C.numRS[1],
+                  &C.numRS[2], &C.lat[0], &C.lat[1], &C.lat[2]) != 6)
+            return line;
+        for(int c=0;c<3;c++)
+            if(C.numRS[c] < 1 || C.lat[c] < 1)
+                return line;
+        CONFIG.push_back(C);
+    }
+    return 0;
+}
+
+//#######################################################################
+// Datapath FUNCTIONS
+void BatchTomasulo::ISSUE(){
+    PROFILE_SCOPE(ProfileIssue);
+    const int K = paddedLanes;
+    int N = rd.size();
+    // op class each lane wants to issue, -1 once its program is issued
+    #pragma GCC ivdep
+    for(int k=0;k<K;k++){
+        issueClass[k] = currentInst_ISSUE[k] < N ? cls[currentInst_ISSUE[k]] : -1;
+        chosen[k] = -1;
+    }
+    // first free station of that class
+    for(int c=0;c<3;c++){
+        const int* n = &numRS[c][0];
+        int* C = &chosen[0];
+        const int* IC = &issueClass[0];
+        for(int j=0;j<maxRS[c];j++){
+            int s = classStart[c]+j;
+            const int* B = &busy[s*K];
+            #pragma GCC ivdep
+            for(int k=0;k<K;k++)
+                C[k] = ((C[k] < 0) & (IC[k] == c) & (j < n[k]) & !B[k]) ? s : C[k];
+        }
+    }
+    // operand tags come from the register status, one gather per lane
+    for(int k=0;k<lanes;k++){
+        int s = chosen[k];
+        if(s < 0)
+            continue;
+        int i = currentInst_ISSUE[k]++;
+        busy[s*K+k] = 1;
+        issueLat[s*K+k] = 0;
+        Qj[s*K+k] = Qi[rs[i]*K+k];
+        Qk[s*K+k] = Qi[rt[i]*K+k];
+        Qi[rd[i]*K+k] = 1u << s;
+    }
+}
+void BatchTomasulo::EXECUTE(){
+    PROFILE_SCOPE(ProfileExecute);
+    const int K = paddedLanes;
+    for(int c=0;c<3;c++){
+        const int* L = &classLat[c][0];
+        for(int s=classStart[c];s<classStart[c]+maxRS[c];s++){
+            const int* B = &busy[s*K];
+            const unsigned* J = &Qj[s*K];
+            const unsigned* Kk = &Qk[s*K];
+            int* T = &lat[s*K];
+            int* R = &resultReady[s*K];
+            int* IL = &issueLat[s*K];
+            #pragma GCC ivdep
+            for(int k=0;k<K;k++){
+                int waiting = B[k] & (IL[k] < ISSUE_Lat);
+                int ready = B[k] & (IL[k] >= ISSUE_Lat) & ((J[k] | Kk[k]) == 0);
+                int t = T[k] + ready;
+                int finish = ready & (t == L[k]);
+                R[k] |= finish;
+                T[k] = finish ? 0 : t;
+                // ISSUE latency counts up before execution and
+                // is reset when the result is ready
+                IL[k] = waiting ? IL[k]+1 : (finish ? 0 : IL[k]);
+            }
+        }
+    }
+}
+void BatchTomasulo::WRITEBACK(){
+    PROFILE_SCOPE(ProfileWriteback);
+    const int K = paddedLanes;
+    unsigned* W = &wbMask[0];
+    #pragma GCC ivdep
+    for(int k=0;k<K;k++)
+        W[k] = 0;
+    // stations writing back this cycle, as a mask per lane
+    for(int s=0;s<S;s++){
+        int* B = &busy[s*K];
+        int* R = &resultReady[s*K];
+        int* WL = &writebackLat[s*K];
+        #pragma GCC ivdep
+        for(int k=0;k<K;k++){
+            int wb = R[k] & (WL[k] == WRITEBACK_Lat);
+            WL[k] = wb ? 0 : WL[k] + R[k];
+            W[k] |= (unsigned)wb << s;
+            B[k] &= !wb;
+            R[k] &= !wb;
+        }
+    }
+    // broadcast: operands and registers waiting on them are now available
+    for(int s=0;s<S;s++){
+        unsigned* J = &Qj[s*K];
+        unsigned* Kk = &Qk[s*K];
+        #pragma GCC ivdep
+        for(int k=0;k<K;k++){
+            J[k] &= ~W[k];
+            Kk[k] &= ~W[k];
+        }
+    }
+    for(int x=0;x<(int)Qi.size()/K;x++){
+        unsigned* Q = &Qi[x*K];
+        #pragma GCC ivdep
+        for(int k=0;k<K;k++)
+            Q[k] &= ~W[k];
+    }
+    for(int k=0;k<lanes;k++)
+        Total_WRITEBACKS[k] += __builtin_popcount(W[k]);
+}
+//#######################################################################
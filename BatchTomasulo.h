@@ -0,0 +1,75 @@
+//
+// Batched timing model: K architectures of the same program advanced
+// together, one lane per architecture.
+//
+
+#ifndef TOMASULO_BATCHTOMASULO_H
+#define TOMASULO_BATCHTOMASULO_H
+
+#include <vector>
+#include "Instruction.h"
+
+// Lanes are padded to a multiple of this so the inner loops vectorize
+const int BatchLaneAlign = 8;
+// Tags are one-hot station masks
+const int BatchMaxStations = 32;
+
+// One architecture to simulate
+class BatchConfig {
+    public:
+        int numRS[3];   // ADD/SUB, MULT, DIV stations
+        int lat[3];     // ADD/SUB, MULT, DIV latency
+    public:
+        BatchConfig();
+        BatchConfig(int, int, int, int, int, int);
+};
+
+// Same timing as Tomasulo (ISSUE, EXECUTE, WRITEBACK) without register
+// values, which cannot change the timing. Per station state is laid
+// out [station][lane] so each update is a loop over contiguous lanes.
+class BatchTomasulo {
+    public:
+        int lanes;          // configurations, without padding
+        int Clock;
+        std::vector<BatchConfig> Config;
+        // Results per lane
+        std::vector<int> doneClock;     // 0 while the lane is running
+    private:
+        int paddedLanes;    // lanes rounded up to BatchLaneAlign
+        int S;              // stations per lane (max of each class)
+        int classStart[3];
+        int maxRS[3];
+        // Program, shared by all lanes
+        std::vector<int> rd, rs, rt, cls;
+        // [lane]
+        std::vector<int> currentInst_ISSUE, Total_WRITEBACKS;
+        std::vector<int> numRS[3], classLat[3];
+        // [station][lane]
+        std::vector<int> busy, lat, resultReady, issueLat, writebackLat;
+        // Tags as one-hot masks (1 << station), 0 = operand available,
+        // so a broadcast is a single and-not per lane
+        std::vector<unsigned> Qj, Qk;
+        // [register][lane]
+        std::vector<unsigned> Qi;
+        // scratch [lane]
+        std::vector<int> chosen, issueClass;
+        std::vector<unsigned> wbMask;
+    //**** Methods
+    public:
+        BatchTomasulo(const std::vector<BatchConfig>& CONFIG,
+                      const std::vector<Instruction>& PROGRAM, int numRegisters);
+        void cycle();
+        bool done();
+    private:
+        void ISSUE();
+        void EXECUTE();
+        void WRITEBACK();
+};
+
+// Read a list of architectures, one per line:
+//     4,2,3  4,12,38      // stations A,M,D  latency A,M,D
+// Returns the line number of the first bad line, -1 if the file
+// cannot be opened, 0 on success.
+int readBatchConfigs(const char* path, std::vector<BatchConfig>& CONFIG);
+
+#endif //TOMASULO_BATCHTOMASULO_H
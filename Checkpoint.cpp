@@ -0,0 +1,306 @@
+//
+// Binary checkpoints of the complete machine state.
+//
+// Layout (native endian, every field a 32 bit int):
+//     "TOMCKPT" '\0', version
+//     Num_ADD_RS Num_MULT_RS Num_DIV_RS ADD_Lat MULT_Lat DIV_Lat
+//     scheduler Num_RS ADD_Cap MULT_Cap DIV_Cap
+//     Clock resolvedValues issuePolicy lastIssued
+//     count, count x HardwareThread:
+//         currentInst_ISSUE Total_WRITEBACKS
+//         count, count x Instruction
+//         count, count x RegisterStatus
+//         count, count x Register
+//     count, count x ReservationStation (Port is rebuilt from RS.port)
+//
+
+#include <cstring>
+#include <fstream>
+#include "Checkpoint.h"
+
+using namespace std;
+
+static const char Magic[8] = {'T','O','M','C','K','P','T','\0'};
+static const int Version = 4;
+// Sanity limit on vector sizes read from a file
+static const int MaxCount = 1 << 30;
+
+static void put(ostream& out, int x){
+    out.write((const char*)&x, sizeof(x));
+}
+static bool get(istream& in, int& x){
+    in.read((char*)&x, sizeof(x));
+    return (bool)in;
+}
+static bool get(istream& in, bool& x){
+    int v;
+    if(!get(in, v))
+        return false;
+    x = v != 0;
+    return true;
+}
+static bool getCount(istream& in, int& count){
+    return get(in, count) && count >= 0 && count <= MaxCount;
+}
+// TAG, which an instruction of thread T waits on, names a busy station
+// holding an older instruction of T (so there are no wait cycles)
+static bool validProducer(const Tomasulo& M, int tag, int t, int instNum){
+    if(tag < 0 || tag >= (int)M.ResStation.size())
+        return false;
+    const ReservationStation& P = M.ResStation[tag];
+    return P.busy && P.thread == t && P.instNum < instNum;
+}
+// Op class (0 ADD/SUB, 1 MULT, 2 DIV) of OP
+static int opClass(int op){
+    return op == MultOp ? 1 : op == DivOp ? 2 : 0;
+}
+// The invariants the datapath relies on, so a damaged or edited
+// checkpoint is rejected instead of hanging or indexing out of range
+static bool valid(const Tomasulo& M){
+    const int numUnits[3] = {M.Num_ADD_RS, M.Num_MULT_RS, M.Num_DIV_RS};
+    const int lat[3] = {M.ADD_Lat, M.MULT_Lat, M.DIV_Lat};
+    const int cap[3] = {M.ADD_Cap, M.MULT_Cap, M.DIV_Cap};
+    for(int c=0;c<3;c++)
+        if(numUnits[c] < 1 || numUnits[c] >= MaxRS || lat[c] < 1 || cap[c] < 0)
+            return false;
+    if(numUnits[0]+numUnits[1]+numUnits[2] >= MaxRS ||
+       (M.scheduler != PartitionedRS && M.scheduler != UnifiedRS) ||
+       (M.scheduler == UnifiedRS && (M.Num_RS < 1 || M.Num_RS >= MaxRS)) ||
+       (M.issuePolicy != RoundRobinIssue && M.issuePolicy != ICountIssue) ||
+       M.Clock < 0 || M.lastIssued < 0 || M.lastIssued >= (int)M.Thread.size())
+        return false;
+    int numStations = M.ResStation.size();
+    int numThreads = M.Thread.size();
+    // per thread: issued instructions still in a station
+    vector<vector<bool> > inStation(numThreads);
+    for(int t=0;t<numThreads;t++){
+        const HardwareThread& T = M.Thread[t];
+        int numInst = T.Inst.size();
+        int numRegisters = T.Register.size();
+        if(numRegisters == 0 || T.Total_WRITEBACKS < 0 ||
+           T.Total_WRITEBACKS > T.currentInst_ISSUE || T.currentInst_ISSUE > numInst)
+            return false;
+        for(int i=0;i<numInst;i++){
+            const Instruction& I = T.Inst[i];
+            if(I.rd < 0 || I.rd >= numRegisters ||
+               I.rs < 0 || I.rs >= numRegisters ||
+               I.rt < 0 || I.rt >= numRegisters ||
+               I.op < AddOp || I.op > DivOp)
+                return false;
+        }
+        inStation[t].assign(T.currentInst_ISSUE, false);
+    }
+    // end of each class in the units, and in the stations of a
+    // partitioned machine
+    const int classEnd[3] = {numUnits[0], numUnits[0]+numUnits[1],
+                             numUnits[0]+numUnits[1]+numUnits[2]};
+    for(int r=0;r<numStations;r++){
+        const ReservationStation& RS = M.ResStation[r];
+        if(RS.op < AddOp || RS.op > DivOp)
+            return false;
+        int c = opClass(RS.op);
+        if(M.scheduler == PartitionedRS &&
+           (r >= classEnd[c] || (c > 0 && r < classEnd[c-1])))
+            return false;
+        if(!RS.busy){
+            // as WRITEBACK leaves a station, issue() keeps the counters
+            if(RS.resultReady || RS.port != -1 || RS.lat != 0 || RS.WRITEBACK_Lat != 0 ||
+               RS.Qj != OperandInit || RS.Qk != OperandInit)
+                return false;
+            continue;
+        }
+        // EXECUTE counts lat up to the latency exactly, then WRITEBACK
+        // counts WRITEBACK_Lat
+        if(RS.lat < 0 || RS.lat >= lat[c] || RS.ISSUE_Lat < 0 ||
+           RS.WRITEBACK_Lat < 0 || RS.WRITEBACK_Lat > WRITEBACK_Lat ||
+           (RS.resultReady ? RS.lat != 0 : RS.WRITEBACK_Lat != 0))
+            return false;
+        // an issued instruction, in no other station
+        if(RS.instNum < 0 || RS.instNum >= (int)inStation[RS.thread].size() ||
+           inStation[RS.thread][RS.instNum])
+            return false;
+        inStation[RS.thread][RS.instNum] = true;
+        if((RS.Qj != OperandAvailable && !validProducer(M, RS.Qj, RS.thread, RS.instNum)) ||
+           (RS.Qk != OperandAvailable && !validProducer(M, RS.Qk, RS.thread, RS.instNum)))
+            return false;
+        // a unit is only held while executing, by a unit of the class
+        if(RS.port >= 0 &&
+           (RS.resultReady || RS.Qj != OperandAvailable || RS.Qk != OperandAvailable ||
+            RS.port >= classEnd[c] || (c > 0 && RS.port < classEnd[c-1])))
+            return false;
+    }
+    for(int t=0;t<numThreads;t++){
+        const HardwareThread& T = M.Thread[t];
+        // every issued instruction is written back or in a station
+        int busy = 0;
+        for(int i=0;i<(int)inStation[t].size();i++)
+            busy += inStation[t][i];
+        if(T.Total_WRITEBACKS + busy != T.currentInst_ISSUE)
+            return false;
+        // a register waits for the newest writer still in a station
+        for(int x=0;x<(int)T.RegStatus.size();x++)
+            if(T.RegStatus[x].Qi != RegStatusEmpty &&
+               !validProducer(M, T.RegStatus[x].Qi, t, T.currentInst_ISSUE))
+                return false;
+    }
+    return true;
+}
+
+bool saveCheckpoint(ostream& out, const Tomasulo& CPU){
+    for(int t=0;t<(int)CPU.Thread.size();t++)
+        if(CPU.Thread[t].retired > 0)
+            return false;
+    out.write(Magic, sizeof(Magic));
+    put(out, Version);
+    put(out, CPU.Num_ADD_RS);
+    put(out, CPU.Num_MULT_RS);
+    put(out, CPU.Num_DIV_RS);
+    put(out, CPU.ADD_Lat);
+    put(out, CPU.MULT_Lat);
+    put(out, CPU.DIV_Lat);
+    put(out, CPU.scheduler);
+    put(out, CPU.Num_RS);
+    put(out, CPU.ADD_Cap);
+    put(out, CPU.MULT_Cap);
+    put(out, CPU.DIV_Cap);
+    put(out, CPU.Clock);
+    put(out, CPU.resolvedValues);
+    put(out, CPU.issuePolicy);
+    put(out, CPU.lastIssued);
+
+    put(out, CPU.Thread.size());
+    for(int t=0;t<(int)CPU.Thread.size();t++){
+        const HardwareThread& T = CPU.Thread[t];
+        put(out, T.currentInst_ISSUE);
+        put(out, T.Total_WRITEBACKS);
+        put(out, T.Inst.size());
+        for(int i=0;i<(int)T.Inst.size();i++){
+            const Instruction& I = T.Inst[i];
+            put(out, I.rd);
+            put(out, I.rs);
+            put(out, I.rt);
+            put(out, I.op);
+            put(out, I.issueClock);
+            put(out, I.executeClockBegin);
+            put(out, I.executeClockEnd);
+            put(out, I.writebackClock);
+            put(out, I.result);
+        }
+        put(out, T.RegStatus.size());
+        for(int x=0;x<(int)T.RegStatus.size();x++){
+            put(out, T.RegStatus[x].busy);
+            put(out, T.RegStatus[x].Qi);
+        }
+        put(out, T.Register.size());
+        for(int x=0;x<(int)T.Register.size();x++)
+            put(out, T.Register[x]);
+    }
+    put(out, CPU.ResStation.size());
+    for(int r=0;r<(int)CPU.ResStation.size();r++){
+        const ReservationStation& RS = CPU.ResStation[r];
+        put(out, RS.busy);
+        put(out, RS.Qj);
+        put(out, RS.Qk);
+        put(out, RS.Vj);
+        put(out, RS.Vk);
+        put(out, RS.lat);
+        put(out, RS.op);
+        put(out, RS.result);
+        put(out, RS.resultReady);
+        put(out, RS.instNum);
+        put(out, RS.thread);
+        put(out, RS.port);
+        put(out, RS.ISSUE_Lat);
+        put(out, RS.WRITEBACK_Lat);
+    }
+    return (bool)out;
+}
+
+bool loadCheckpoint(istream& in, Tomasulo& CPU){
+    char magic[sizeof(Magic)];
+    int version;
+    in.read(magic, sizeof(magic));
+    if(!in || memcmp(magic, Magic, sizeof(Magic)) != 0)
+        return false;
+    if(!get(in, version) || version != Version)
+        return false;
+
+    // Read into a copy so CPU is untouched on failure
+    Tomasulo M = CPU;
+    int count;
+    if(!get(in, M.Num_ADD_RS) || !get(in, M.Num_MULT_RS) || !get(in, M.Num_DIV_RS) ||
+       !get(in, M.ADD_Lat) || !get(in, M.MULT_Lat) || !get(in, M.DIV_Lat) ||
+       !get(in, M.scheduler) || !get(in, M.Num_RS) ||
+       !get(in, M.ADD_Cap) || !get(in, M.MULT_Cap) || !get(in, M.DIV_Cap) ||
+       !get(in, M.Clock) || !get(in, M.resolvedValues) ||
+       !get(in, M.issuePolicy) || !get(in, M.lastIssued))
+        return false;
+
+    if(!getCount(in, count) || count < 1)
+        return false;
+    M.Thread.assign(count, HardwareThread());
+    for(int t=0;t<(int)M.Thread.size();t++){
+        HardwareThread& T = M.Thread[t];
+        if(!get(in, T.currentInst_ISSUE) || !get(in, T.Total_WRITEBACKS) ||
+           !getCount(in, count))
+            return false;
+        T.Inst.resize(count);
+        for(int i=0;i<count;i++){
+            Instruction& I = T.Inst[i];
+            if(!get(in, I.rd) || !get(in, I.rs) || !get(in, I.rt) || !get(in, I.op) ||
+               !get(in, I.issueClock) || !get(in, I.executeClockBegin) ||
+               !get(in, I.executeClockEnd) || !get(in, I.writebackClock) ||
+               !get(in, I.result))
+                return false;
+        }
+        if(!getCount(in, count))
+            return false;
+        T.RegStatus.resize(count);
+        for(int x=0;x<count;x++)
+            if(!get(in, T.RegStatus[x].busy) || !get(in, T.RegStatus[x].Qi))
+                return false;
+        if(!getCount(in, count) || count != (int)T.RegStatus.size())
+            return false;
+        T.Register.resize(count);
+        for(int x=0;x<count;x++)
+            if(!get(in, T.Register[x]))
+                return false;
+    }
+    int numUnits = M.Num_ADD_RS+M.Num_MULT_RS+M.Num_DIV_RS;
+    if(!getCount(in, count) ||
+       count != (M.scheduler == UnifiedRS ? M.Num_RS : numUnits))
+        return false;
+    M.ResStation.resize(count);
+    M.Port.assign(M.scheduler == UnifiedRS ? numUnits : 0, -1);
+    for(int r=0;r<count;r++){
+        ReservationStation& RS = M.ResStation[r];
+        if(!get(in, RS.busy) || !get(in, RS.Qj) || !get(in, RS.Qk) ||
+           !get(in, RS.Vj) || !get(in, RS.Vk) || !get(in, RS.lat) ||
+           !get(in, RS.op) || !get(in, RS.result) || !get(in, RS.resultReady) ||
+           !get(in, RS.instNum) || !get(in, RS.thread) || !get(in, RS.port) ||
+           !get(in, RS.ISSUE_Lat) || !get(in, RS.WRITEBACK_Lat) ||
+           RS.thread < 0 || RS.thread >= (int)M.Thread.size() ||
+           RS.port < -1 || RS.port >= (int)M.Port.size())
+            return false;
+        if(RS.port >= 0){
+            // a unit is held by one station at a time
+            if(M.Port[RS.port] >= 0)
+                return false;
+            M.Port[RS.port] = r;
+        }
+    }
+    if(!valid(M))
+        return false;
+
+    CPU = M;
+    return true;
+}
+
+bool saveCheckpoint(const char* path, const Tomasulo& CPU){
+    ofstream out(path, ios::binary);
+    return out.is_open() && saveCheckpoint(out, CPU);
+}
+bool loadCheckpoint(const char* path, Tomasulo& CPU){
+    ifstream in(path, ios::binary);
+    return in.is_open() && loadCheckpoint(in, CPU);
+}
@@ -0,0 +1,23 @@
+//
+// Binary checkpoints of the complete machine state.
+//
+
+#ifndef TOMASULO_CHECKPOINT_H
+#define TOMASULO_CHECKPOINT_H
+
+#include <iostream>
+#include "Tomasulo.h"
+
+// Save/restore architecture, Clock, every reservation station and,
+// for each hardware thread, the issue pointer, register status,
+// registers and the program with its timing fields. A streamed Source
+// is not saved: after a restore the caller re-attaches each thread's
+// stream and skips the first Thread[t].Inst.size() instructions, so
+// a machine that dropped retired instructions cannot be saved.
+// Return false on an I/O error or a file that is not a checkpoint.
+bool saveCheckpoint(std::ostream& out, const Tomasulo& CPU);
+bool loadCheckpoint(std::istream& in, Tomasulo& CPU);
+bool saveCheckpoint(const char* path, const Tomasulo& CPU);
+bool loadCheckpoint(const char* path, Tomasulo& CPU);
+
+#endif //TOMASULO_CHECKPOINT_H
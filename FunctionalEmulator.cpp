@@ -0,0 +1,53 @@
+//
+// Functional model: architectural register values only, no timing.
+//
+
+#include <climits>
+#include "FunctionalEmulator.h"
+
+using namespace std;
+
+int ALU(int op, int Vj, int Vk){
+    // wraps around in unsigned like EXECUTE, signed overflow is undefined
+    switch(op){
+        case(AddOp):
+            return (int)((unsigned)Vj + (unsigned)Vk);
+        case(SubOp):
+            return (int)((unsigned)Vj - (unsigned)Vk);
+        case(MultOp):
+            return (int)((unsigned)Vj * (unsigned)Vk);
+        case(DivOp):
+            if(Vk == 0 || (Vk == -1 && Vj == INT_MIN))
+                return 0;
+            return Vj / Vk;
+        default:
+            return 0;
+    }
+}
+void functionalStep(const Instruction& INST, vector<int>& Register){
+    Register[INST.rd] = ALU(INST.op, Register[INST.rs], Register[INST.rt]);
+}
+
+
+FunctionalEmulator::FunctionalEmulator(InstructionSource* SOURCE,
+                                       const vector<int>& REGISTER){
+    Source = SOURCE;
+    Register = REGISTER;
+    executed = 0;
+    error = false;
+}
+bool FunctionalEmulator::next(Instruction& INST){
+    if(error || !Source->next(INST))
+        return false;
+    int numRegisters = Register.size();
+    if(INST.rd < 0 || INST.rd >= numRegisters ||
+       INST.rs < 0 || INST.rs >= numRegisters ||
+       INST.rt < 0 || INST.rt >= numRegisters){
+        error = true;
+        return false;
+    }
+    functionalStep(INST, Register);
+    INST.result = Register[INST.rd];
+    executed++;
+    return true;
+}
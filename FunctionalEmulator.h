@@ -0,0 +1,32 @@
+//
+// Functional model: architectural register values only, no timing.
+//
+
+#ifndef TOMASULO_FUNCTIONALEMULATOR_H
+#define TOMASULO_FUNCTIONALEMULATOR_H
+
+#include <vector>
+#include "InstructionSource.h"
+
+// Architectural effect of one instruction: Register[rd] = rs op rt.
+// Same arithmetic as EXECUTE.
+int ALU(int op, int Vj, int Vk);
+void functionalStep(const Instruction& INST, std::vector<int>& Register);
+
+// Runs ahead of the timing model: pulls instructions from SOURCE,
+// executes them on its own register file and hands them on with
+// Instruction::result filled in.
+class FunctionalEmulator : public InstructionSource {
+    public:
+        std::vector<int> Register;
+        long long executed;
+        bool error;         // an instruction used a register outside Register
+    private:
+        InstructionSource* Source;
+    //**** Methods
+    public:
+        FunctionalEmulator(InstructionSource* SOURCE, const std::vector<int>& REGISTER);
+        bool next(Instruction&);
+};
+
+#endif //TOMASULO_FUNCTIONALEMULATOR_H
@@ -0,0 +1,31 @@
+//
+// Per-thread state of an SMT core: program, issue pointer and
+// register file. The reservation stations are shared (see Tomasulo).
+//
+
+#include <cstddef>
+#include "HardwareThread.h"
+
+HardwareThread::HardwareThread(){
+    currentInst_ISSUE = 0;
+    Total_WRITEBACKS = 0;
+    retired = 0;
+    retiredWriteback = 0;
+    Source = NULL;
+}
+// Thread is done once every instruction has been written back
+bool HardwareThread::done(){
+    return Source == NULL && Total_WRITEBACKS == (int)Inst.size();
+}
+// Instructions fetched so far, including the retired ones
+long long HardwareThread::numInstructions(){
+    return retired + Inst.size();
+}
+// A thread's own cycles: up to its last writeback
+int HardwareThread::lastWriteback(){
+    int last = retiredWriteback;
+    for(int i=0;i<(int)Inst.size();i++)
+        if(Inst[i].writebackClock > last)
+            last = Inst[i].writebackClock;
+    return last;
+}
@@ -0,0 +1,38 @@
+//
+// Per-thread state of an SMT core: program, issue pointer and
+// register file. The reservation stations are shared (see Tomasulo).
+//
+
+#ifndef TOMASULO_HARDWARETHREAD_H
+#define TOMASULO_HARDWARETHREAD_H
+
+#include <vector>
+#include "Instruction.h"
+#include "RegisterStatus.h"
+#include "InstructionSource.h"
+
+class HardwareThread {
+    public:
+        // Counter for current instruction to issue
+        int currentInst_ISSUE;
+        // used to check if INST == WRITEBACKS to end program
+        int Total_WRITEBACKS;
+        std::vector<Instruction> Inst;
+        // Written-back instructions dropped from the front of Inst
+        // (see Tomasulo::keepRetired) and the last writeback among them
+        long long retired;
+        int retiredWriteback;
+        std::vector<RegisterStatus> RegStatus;
+        std::vector<int> Register;
+        // Streamed program, pulled into Inst as instructions issue.
+        // NULL for a fixed program or once the stream is exhausted.
+        InstructionSource* Source;
+    //**** Methods
+    public:
+        HardwareThread();
+        bool done();
+        long long numInstructions();
+        int lastWriteback();
+};
+
+#endif //TOMASULO_HARDWARETHREAD_H
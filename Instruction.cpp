@@ -13,6 +13,7 @@ Instruction::Instruction() {
     executeClockBegin = 0;
     executeClockEnd = 0;
     writebackClock = 0;
+    result = 0;
 }
 
 Instruction::Instruction(int RD,int RS, int RT, int OP) {
@@ -24,4 +25,5 @@ Instruction::Instruction(int RD,int RS, int RT, int OP) {
     executeClockBegin = 0;
     executeClockEnd = 0;
     writebackClock = 0;
+    result = 0;
 }
\ No newline at end of file
@@ -5,6 +5,12 @@
 #ifndef TOMASULO_INSTRUCTION_H
 #define TOMASULO_INSTRUCTION_H
 
+// Opcode Values
+const int AddOp = 0;
+const int SubOp = 1;
+const int MultOp = 2;
+const int DivOp = 3;
+
 
 class Instruction {
     public:
@@ -16,6 +22,7 @@ class Instruction {
         int executeClockBegin;
         int executeClockEnd;
         int writebackClock;
+        int result; // resolved by a FunctionalEmulator, see Tomasulo::resolvedValues
     //**** Class methods
     public:
         Instruction();
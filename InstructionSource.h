@@ -0,0 +1,18 @@
+//
+// Stream of instructions pulled by the simulator one at a time.
+//
+
+#ifndef TOMASULO_INSTRUCTIONSOURCE_H
+#define TOMASULO_INSTRUCTIONSOURCE_H
+
+#include "Instruction.h"
+
+class InstructionSource {
+    public:
+        virtual ~InstructionSource() {}
+        // Fill INST with the next instruction. Returns false
+        // once the stream is exhausted.
+        virtual bool next(Instruction& INST) = 0;
+};
+
+#endif //TOMASULO_INSTRUCTIONSOURCE_H
@@ -0,0 +1,107 @@
+//
+// Options of one simulation (program and architecture), parsed the
+// same way from the command line and from server jobs.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "JobOptions.h"
+
+using namespace std;
+
+JobOptions::JobOptions(){
+    generate = false;
+    numRS[0] = 4;
+    numRS[1] = 2;
+    numRS[2] = 3;
+    lat[0] = 4;
+    lat[1] = 12;
+    lat[2] = 38;
+    unifiedRS = 0;
+    cap[0] = 0;
+    cap[1] = 0;
+    cap[2] = 0;
+    numSMT = 1;
+    issuePolicy = RoundRobinIssue;
+    rsGiven = false;
+    latGiven = false;
+    capGiven = false;
+    smtGiven = false;
+    issueGiven = false;
+}
+int JobOptions::parse(const char* option, const char* value){
+    int* mix = Generator.mix;
+    if(strcmp(option,"-n") == 0){
+        Generator.length = atoll(value);
+        generate = true;
+    }
+    else if(strcmp(option,"-mix") == 0){
+        // weights may be 0 but not negative, and not all 0
+        if(sscanf(value,"%d,%d,%d,%d",&mix[AddOp],&mix[SubOp],&mix[MultOp],&mix[DivOp]) != 4 ||
+           mix[AddOp] < 0 || mix[SubOp] < 0 || mix[MultOp] < 0 || mix[DivOp] < 0 ||
+           (long long)mix[AddOp] + mix[SubOp] + mix[MultOp] + mix[DivOp] == 0)
+            return -1;
+    }
+    else if(strcmp(option,"-dep") == 0)
+        Generator.depDist = atof(value);
+    else if(strcmp(option,"-regs") == 0)
+        Generator.regPool = atoi(value);
+    else if(strcmp(option,"-seed") == 0)
+        Generator.seed = strtoul(value,NULL,0);
+    else if(strcmp(option,"-t") == 0)
+        traceIn = value;
+    else if(strcmp(option,"-rs") == 0){
+        // station tags must stay below the sentinels
+        if(sscanf(value,"%d,%d,%d",&numRS[0],&numRS[1],&numRS[2]) != 3 ||
+           numRS[0] < 1 || numRS[1] < 1 || numRS[2] < 1 ||
+           numRS[0] >= MaxRS || numRS[1] >= MaxRS || numRS[2] >= MaxRS ||
+           numRS[0]+numRS[1]+numRS[2] >= MaxRS)
+            return -1;
+        rsGiven = true;
+    }
+    else if(strcmp(option,"-lat") == 0){
+        if(sscanf(value,"%d,%d,%d",&lat[0],&lat[1],&lat[2]) != 3 ||
+           lat[0] < 1 || lat[1] < 1 || lat[2] < 1)
+            return -1;
+        latGiven = true;
+    }
+    else if(strcmp(option,"-unified") == 0){
+        unifiedRS = atoi(value);
+        if(unifiedRS < 1 || unifiedRS >= MaxRS)
+            return -1;
+    }
+    else if(strcmp(option,"-cap") == 0){
+        if(sscanf(value,"%d,%d,%d",&cap[0],&cap[1],&cap[2]) != 3 ||
+           cap[0] < 0 || cap[1] < 0 || cap[2] < 0)
+            return -1;
+        capGiven = true;
+    }
+    else if(strcmp(option,"-smt") == 0){
+        numSMT = atoi(value);
+        if(numSMT < 1 || numSMT > MaxSMT)
+            return -1;
+        smtGiven = true;
+    }
+    else if(strcmp(option,"-issue") == 0){
+        if(strcmp(value,"rr") == 0)
+            issuePolicy = RoundRobinIssue;
+        else if(strcmp(value,"icount") == 0)
+            issuePolicy = ICountIssue;
+        else
+            return -1;
+        issueGiven = true;
+    }
+    else
+        return 0;
+    return 1;
+}
+const char* JobOptions::check(){
+    if(Generator.regPool < 2 || Generator.regPool > MaxRegisters)
+        return "-regs needs 2 to 4096 registers";
+    if(Generator.length < 0)
+        return "-n must not be negative";
+    if(capGiven && unifiedRS == 0)
+        return "-cap needs -unified";
+    return NULL;
+}
@@ -0,0 +1,48 @@
+//
+// Options of one simulation (program and architecture), parsed the
+// same way from the command line and from server jobs.
+//
+
+#ifndef TOMASULO_JOBOPTIONS_H
+#define TOMASULO_JOBOPTIONS_H
+
+#include <string>
+#include "WorkloadGenerator.h"
+#include "Tomasulo.h"
+
+// Upper bounds, so a bad value is refused instead of exhausting memory
+const int MaxRegisters = 4096;      // -regs
+const int MaxSMT = 64;              // -smt
+
+// -n -mix -dep -regs -seed -t -rs -lat -unified -cap -smt -issue,
+// each with one value
+class JobOptions {
+    public:
+        WorkloadGenerator Generator;
+        bool generate;          // -n given
+        std::string traceIn;    // empty without -t
+        // defaults as in a fresh Tomasulo
+        int numRS[3];
+        int lat[3];
+        int unifiedRS;          // 0 = partitioned stations
+        int cap[3];             // 0 = no cap
+        int numSMT;
+        int issuePolicy;
+        // given explicitly (they override a restored architecture)
+        bool rsGiven;
+        bool latGiven;
+        bool capGiven;
+        bool smtGiven;
+        bool issueGiven;
+    //**** Methods
+    public:
+        JobOptions();
+        // Returns 1 if OPTION is a job option and VALUE is good for
+        // it, 0 if OPTION is not a job option, -1 for a bad VALUE
+        int parse(const char* option, const char* value);
+        // Checks the options together once all are parsed. Returns
+        // NULL if they are fine, otherwise what is wrong.
+        const char* check();
+};
+
+#endif //TOMASULO_JOBOPTIONS_H
@@ -0,0 +1,70 @@
+//
+// Several Tomasulo cores advanced in parallel host threads.
+//
+
+#include <climits>
+#include <thread>
+#include "Multicore.h"
+
+using namespace std;
+
+Multicore::Multicore(const vector<Tomasulo*>& CORE, int QUANTUM, SharedCDB* cdb)
+        : coresDone(0) {
+    Core = CORE;
+    quantum = QUANTUM;
+    CDB = cdb;
+    status.assign(Core.size(), 0);
+    quantumEnd = 0;
+    allDone = false;
+    for(int c=0;c<(int)Core.size();c++){
+        Core[c]->CDB = CDB;
+        Core[c]->core = c;
+    }
+}
+// Run every core to the end, cores spread evenly over numThreads
+// host threads.
+void Multicore::run(int numThreads){
+    if(numThreads > (int)Core.size())
+        numThreads = Core.size();
+    quantumEnd = quantum;
+    allDone = Core.empty();
+    // End of a quantum: every core is stopped, free the shared
+    // CDB slots of the quantum and start the next one
+    Barrier B(numThreads, [this](){
+        if(CDB != NULL)
+            CDB->clear();
+        // the last quantum runs up to the largest clock
+        quantumEnd = quantumEnd > INT_MAX-quantum ? INT_MAX : quantumEnd+quantum;
+        allDone = coresDone.load() == (int)Core.size();
+    });
+    vector<thread> Threads;
+    for(int t=0;t<numThreads;t++)
+        Threads.push_back(thread(&Multicore::runThread, this,
+                                 Core.size()*t/numThreads,
+                                 Core.size()*(t+1)/numThreads, ref(B)));
+    for(int t=0;t<numThreads;t++)
+        Threads[t].join();
+}
+// A core only waits on the shared CDB for lower-numbered cores, so
+// each host thread runs its cores in increasing order
+void Multicore::runThread(int first, int last, Barrier& B){
+    while(!allDone){
+        for(int c=first;c<last;c++){
+            Tomasulo* CPU = Core[c];
+            // a core at the last clock stops on the next cycle()
+            while(status[c] == 0 && (CPU->Clock < quantumEnd || CPU->Clock == INT_MAX)){
+                int result = CPU->cycle();
+                if(result < 0)
+                    status[c] = result;
+                else if(CPU->done())
+                    status[c] = 1;
+                if(status[c] != 0){
+                    coresDone++;
+                    if(CDB != NULL)
+                        CDB->finish(c);
+                }
+            }
+        }
+        B.wait();
+    }
+}
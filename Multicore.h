@@ -0,0 +1,39 @@
+//
+// Several Tomasulo cores advanced in parallel host threads.
+//
+
+#ifndef TOMASULO_MULTICORE_H
+#define TOMASULO_MULTICORE_H
+
+#include <atomic>
+#include <vector>
+#include "Tomasulo.h"
+#include "Barrier.h"
+
+const int MaxQuantum = 1000000;     // -quantum, one CDB slot count per cycle
+
+// Each core has its own program, stations and register file. The
+// cores run one quantum of cycles at a time and then wait at a
+// barrier, so they are never more than a quantum apart. Units shared
+// between the cores (Tomasulo::CDB) are arbitrated in that window.
+class Multicore {
+    public:
+        std::vector<Tomasulo*> Core;
+        int quantum;
+        SharedCDB* CDB;
+        // per core: 0 running, 1 done, -1 stopped on a register
+        // outside its register file, -2 out of clock cycles
+        std::vector<int> status;
+    private:
+        int quantumEnd;     // last clock of the current quantum
+        bool allDone;
+        std::atomic<int> coresDone;
+    //**** Methods
+    public:
+        Multicore(const std::vector<Tomasulo*>& CORE, int QUANTUM, SharedCDB* cdb);
+        void run(int numThreads);
+    private:
+        void runThread(int first, int last, Barrier& B);
+};
+
+#endif //TOMASULO_MULTICORE_H
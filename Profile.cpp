@@ -0,0 +1,159 @@
+//
+// Host-side profiling of the simulator's own stages, see Profile.h.
+//
+
+#ifdef TOMASULO_PROFILE
+
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "Profile.h"
+
+using namespace std;
+
+static const char* StageName[NumProfileStages] = {
+    "fetch", "ISSUE", "EXECUTE", "WRITEBACK", "print"
+};
+static const char* ScanName[NumProfileScans] = {
+    "ISSUE free station search", "EXECUTE stations", "WRITEBACK stations",
+    "WRITEBACK register status", "WRITEBACK operand broadcast"
+};
+// stage a scan runs in, its iterations are reported per call of it
+static const int ScanStage[NumProfileScans] = {
+    ProfileIssue, ProfileExecute, ProfileWriteback, ProfileWriteback, ProfileWriteback
+};
+// Hardware counters, counted in user space for the whole run
+static const int NumEvents = 4;
+static const unsigned long long EventConfig[NumEvents] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+};
+static const char* EventName[NumEvents] = {
+    "cycles", "instructions", "cache misses", "branch misses"
+};
+
+static double seconds(const timespec& t){
+    return t.tv_sec + t.tv_nsec*1e-9;
+}
+
+// Process totals, printed when the program exits
+class ProfileReport {
+    public:
+        mutex lock;
+        unsigned long long ticks[NumProfileStages];
+        unsigned long long calls[NumProfileStages];
+        unsigned long long iterations[NumProfileScans];
+        int perfFd[NumEvents];
+        int perfErrno;
+        unsigned long long startTicks;
+        timespec startTime;
+    //**** Methods
+    public:
+        ProfileReport();
+        ~ProfileReport();
+};
+static ProfileReport report;
+
+ProfileReport::ProfileReport(){
+    memset(ticks, 0, sizeof(ticks));
+    memset(calls, 0, sizeof(calls));
+    memset(iterations, 0, sizeof(iterations));
+    perfErrno = 0;
+    for(int e=0;e<NumEvents;e++){
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = EventConfig[e];
+        // threads started later are counted too
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        perfFd[e] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if(perfFd[e] < 0 && perfErrno == 0)
+            perfErrno = errno;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &startTime);
+    startTicks = profileClock();
+}
+ProfileReport::~ProfileReport(){
+    timespec endTime;
+    clock_gettime(CLOCK_MONOTONIC, &endTime);
+    double wall = seconds(endTime) - seconds(startTime);
+    double ticksPerNs = wall > 0 ? (profileClock() - startTicks)/(wall*1e9) : 1;
+    if(ticksPerNs <= 0)
+        ticksPerNs = 1;
+
+    cerr << endl << "Host profile: " << fixed << setprecision(3) << wall << " s" <<
+            " (timer " << setprecision(2) << ticksPerNs << " ticks/ns," <<
+            " stages summed over host threads)" << endl;
+    cerr << left << setw(12) << "Stage" << right << setw(14) << "Calls" <<
+            setw(14) << "Time ms" << setw(9) << "Share" << setw(12) << "ns/call" << endl;
+    for(int s=0;s<NumProfileStages;s++){
+        double ms = ticks[s]/ticksPerNs*1e-6;
+        cerr << left << setw(12) << StageName[s] << right << setw(14) << calls[s] <<
+                setw(14) << setprecision(3) << ms <<
+                setw(8) << setprecision(1) << (wall > 0 ? 100*ms/(wall*1e3) : 0.0) << "%" <<
+                setw(12) << setprecision(1) << (calls[s] > 0 ? ms*1e6/calls[s] : 0.0) << endl;
+    }
+    cerr << left << setw(30) << "Scan" << right << setw(16) << "Iterations" <<
+            setw(14) << "per call" << endl;
+    for(int i=0;i<NumProfileScans;i++){
+        unsigned long long stageCalls = calls[ScanStage[i]];
+        cerr << left << setw(30) << ScanName[i] << right << setw(16) << iterations[i] <<
+                setw(14) << setprecision(2) <<
+                (stageCalls > 0 ? (double)iterations[i]/stageCalls : 0.0) << endl;
+    }
+    int opened = 0;
+    for(int e=0;e<NumEvents;e++)
+        opened += perfFd[e] >= 0;
+    if(opened == 0){
+        cerr << "Hardware counters unavailable (perf_event_open: " <<
+                strerror(perfErrno) << ")" << endl;
+        return;
+    }
+    cerr << "Hardware counters (user space, whole run):" << endl;
+    unsigned long long value[NumEvents];
+    for(int e=0;e<NumEvents;e++){
+        // count, time enabled, time running; scaled if multiplexed
+        unsigned long long data[3] = {0, 0, 0};
+        value[e] = 0;
+        if(perfFd[e] < 0){
+            cerr << "  " << left << setw(16) << EventName[e] << right << setw(16) <<
+                    "n/a" << endl;
+            continue;
+        }
+        if(read(perfFd[e], data, sizeof(data)) == sizeof(data) && data[2] > 0)
+            value[e] = (unsigned long long)((double)data[0]*data[1]/data[2]);
+        close(perfFd[e]);
+        cerr << "  " << left << setw(16) << EventName[e] << right << setw(16) << value[e] << endl;
+    }
+    if(value[0] > 0 && value[1] > 0)
+        cerr << "  " << left << setw(16) << "IPC" << right << setw(16) << setprecision(3) <<
+                (double)value[1]/value[0] << endl;
+}
+
+thread_local ProfileCounters profileCounters;
+
+ProfileCounters::ProfileCounters(){
+    memset(ticks, 0, sizeof(ticks));
+    memset(calls, 0, sizeof(calls));
+    memset(iterations, 0, sizeof(iterations));
+}
+ProfileCounters::~ProfileCounters(){
+    lock_guard<mutex> guard(report.lock);
+    for(int s=0;s<NumProfileStages;s++){
+        report.ticks[s] += ticks[s];
+        report.calls[s] += calls[s];
+    }
+    for(int i=0;i<NumProfileScans;i++)
+        report.iterations[i] += iterations[i];
+}
+
+#endif //TOMASULO_PROFILE
@@ -0,0 +1,85 @@
+//
+// Host-side profiling of the simulator's own stages. Compiled in only
+// with -DTOMASULO_PROFILE (make profile); otherwise PROFILE_SCOPE and
+// PROFILE_COUNT expand to nothing and cost nothing.
+//
+// PROFILE_SCOPE(stage) times the rest of the enclosing block with the
+// TSC (clock_gettime where there is none) and counts a call.
+// PROFILE_COUNT(scan, n) adds n iterations to an inner scan. Every
+// host thread keeps its own totals, they are merged when it exits.
+// The report, with whole-run perf_event_open hardware counters where
+// the kernel allows them, goes to stderr at program exit.
+//
+
+#ifndef TOMASULO_PROFILE_H
+#define TOMASULO_PROFILE_H
+
+#ifdef TOMASULO_PROFILE
+
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Stages
+const int ProfileFetch = 0;
+const int ProfileIssue = 1;
+const int ProfileExecute = 2;
+const int ProfileWriteback = 3;
+const int ProfilePrint = 4;
+const int NumProfileStages = 5;
+// Inner scans
+const int ProfileIssueScan = 0;         // stations searched for a free one
+const int ProfileExecuteScan = 1;       // stations checked by EXECUTE
+const int ProfileWritebackScan = 2;     // stations checked by WRITEBACK
+const int ProfileRegisterScan = 3;      // register status searched per result
+const int ProfileBroadcastScan = 4;     // stations searched per result
+const int NumProfileScans = 5;
+
+class ProfileCounters {
+    public:
+        unsigned long long ticks[NumProfileStages];
+        unsigned long long calls[NumProfileStages];
+        unsigned long long iterations[NumProfileScans];
+    //**** Methods
+    public:
+        ProfileCounters();
+        // merges into the process totals
+        ~ProfileCounters();
+};
+extern thread_local ProfileCounters profileCounters;
+
+inline unsigned long long profileClock(){
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec*1000000000ULL + now.tv_nsec;
+#endif
+}
+
+class ProfileScope {
+    private:
+        int stage;
+        unsigned long long start;
+    //**** Methods
+    public:
+        ProfileScope(int STAGE) : stage(STAGE), start(profileClock()) {}
+        ~ProfileScope(){
+            profileCounters.ticks[stage] += profileClock() - start;
+            profileCounters.calls[stage]++;
+        }
+};
+
+#define PROFILE_SCOPE(stage) ProfileScope profileScope(stage)
+#define PROFILE_COUNT(scan, n) (profileCounters.iterations[scan] += (n))
+
+#else
+
+#define PROFILE_SCOPE(stage)
+#define PROFILE_COUNT(scan, n)
+
+#endif //TOMASULO_PROFILE
+
+#endif //TOMASULO_PROFILE_H
@@ -9,5 +9,6 @@ RegisterStatus::RegisterStatus(){
     Qi = 0;
 }
 RegisterStatus::RegisterStatus(int RegStatusEmpty) {
+    busy = false;
     Qi = RegStatusEmpty;
 }
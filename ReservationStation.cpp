@@ -15,6 +15,8 @@ ReservationStation::ReservationStation(){
     Vj = 0;
     Vk = 0;
     instNum = 100000;
+    thread = 0;
+    port = -1;
     ISSUE_Lat = 0;
     WRITEBACK_Lat = 0;
 }
@@ -29,6 +31,8 @@ ReservationStation::ReservationStation(int OP, int RSoperandAvailable){
     Vj = 0;
     Vk = 0;
     instNum = 100000;
+    thread = 0;
+    port = -1;
     ISSUE_Lat = 0;
     WRITEBACK_Lat = 0;
 
@@ -18,6 +18,8 @@ class ReservationStation {
         int result;
         bool resultReady;
         int instNum;
+        int thread; // hardware thread that issued instNum
+        int port;   // unit executing the op (unified scheduler), -1 if none
         int ISSUE_Lat;
         int WRITEBACK_Lat;
 
@@ -0,0 +1,222 @@
+//
+// Lock-free single-producer/single-consumer ring of instructions,
+// in process memory or in POSIX shared memory between processes.
+//
+
+#include <cstring>
+#include <new>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "RingBuffer.h"
+
+using namespace std;
+
+static const char Magic[8] = {'T','O','M','R','I','N','G','\0'};
+
+static unsigned long long roundCapacity(unsigned long long capacity){
+    unsigned long long c = 1;
+    while(c < capacity)
+        c <<= 1;
+    return c;
+}
+static size_t ringBytes(unsigned long long capacity){
+    return sizeof(RingBuffer::Header) + capacity*sizeof(RingBuffer::Slot);
+}
+// POSIX shared memory names start with a '/'
+static string shmPath(const char* name){
+    return name[0] == '/' ? string(name) : "/" + string(name);
+}
+// Set up the header in freshly mapped memory
+static RingBuffer::Header* initHeader(void* mem, unsigned long long capacity,
+                                      int numRegisters){
+    RingBuffer::Header* header = new (mem) RingBuffer::Header;
+    header->capacity = capacity;
+    header->numRegisters = numRegisters;
+    header->head.store(0);
+    header->tail.store(0);
+    header->closed.store(RingOpen);
+    header->abandoned.store(0);
+    // magic last: a consumer polling the segment accepts it only
+    // once the rest of the header is in place
+    atomic_thread_fence(memory_order_release);
+    memcpy(header->magic, Magic, sizeof(Magic));
+    return header;
+}
+
+RingBuffer::RingBuffer(){
+    header = NULL;
+    slots = NULL;
+    bytes = 0;
+    cachedHead = 0;
+    cachedTail = 0;
+}
+RingBuffer::RingBuffer(unsigned long long capacity, int numRegisters){
+    capacity = roundCapacity(capacity);
+    bytes = ringBytes(capacity);
+    // page aligned, so the header's cache line alignment holds
+    void* mem = mmap(NULL, bytes, PROT_READ|PROT_WRITE,
+                     MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if(mem == MAP_FAILED)
+        throw bad_alloc();
+    header = initHeader(mem, capacity, numRegisters);
+    slots = (Slot*)(header+1);
+    cachedHead = 0;
+    cachedTail = 0;
+}
+RingBuffer::~RingBuffer(){
+    if(header != NULL)
+        munmap(header, bytes);
+}
+RingBuffer* RingBuffer::create(const char* name, unsigned long long capacity,
+                               int numRegisters){
+    string path = shmPath(name);
+    capacity = roundCapacity(capacity);
+    size_t bytes = ringBytes(capacity);
+    // replace a segment left behind by an earlier run
+    shm_unlink(path.c_str());
+    int fd = shm_open(path.c_str(), O_CREAT|O_EXCL|O_RDWR, 0600);
+    if(fd < 0)
+        return NULL;
+    if(ftruncate(fd, bytes) != 0){
+        ::close(fd);
+        shm_unlink(path.c_str());
+        return NULL;
+    }
+    void* mem = mmap(NULL, bytes, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(mem == MAP_FAILED){
+        shm_unlink(path.c_str());
+        return NULL;
+    }
+    RingBuffer* Ring = new RingBuffer();
+    Ring->header = initHeader(mem, capacity, numRegisters);
+    Ring->slots = (Slot*)(Ring->header+1);
+    Ring->bytes = bytes;
+    Ring->shmName = path;
+    return Ring;
+}
+// Returns NULL if the segment does not exist (yet)
+RingBuffer* RingBuffer::open(const char* name){
+    string path = shmPath(name);
+    int fd = shm_open(path.c_str(), O_RDWR, 0600);
+    if(fd < 0)
+        return NULL;
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(Header)){
+        ::close(fd);
+        return NULL;
+    }
+    void* mem = mmap(NULL, st.st_size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(mem == MAP_FAILED)
+        return NULL;
+    Header* header = (Header*)mem;
+    // push/pop index the slots with capacity-1 as a mask
+    if(memcmp(header->magic, Magic, sizeof(Magic)) != 0 ||
+       header->capacity == 0 || (header->capacity & (header->capacity-1)) != 0 ||
+       ringBytes(header->capacity) != (size_t)st.st_size){
+        munmap(mem, st.st_size);
+        return NULL;
+    }
+    atomic_thread_fence(memory_order_acquire);
+    RingBuffer* Ring = new RingBuffer();
+    Ring->header = header;
+    Ring->slots = (Slot*)(header+1);
+    Ring->bytes = st.st_size;
+    Ring->shmName = path;
+    Ring->cachedHead = header->head.load(memory_order_acquire);
+    Ring->cachedTail = header->tail.load(memory_order_acquire);
+    return Ring;
+}
+bool RingBuffer::push(const Instruction& INST){
+    unsigned long long head = header->head.load(memory_order_relaxed);
+    if(head - cachedTail == header->capacity){
+        cachedTail = header->tail.load(memory_order_acquire);
+        if(head - cachedTail == header->capacity)
+            return false;
+    }
+    Slot& S = slots[head & (header->capacity-1)];
+    S.rd = INST.rd;
+    S.rs = INST.rs;
+    S.rt = INST.rt;
+    S.op = INST.op;
+    S.result = INST.result;
+    header->head.store(head+1, memory_order_release);
+    return true;
+}
+bool RingBuffer::pushWait(const Instruction& INST){
+    while(!push(INST)){
+        if(header->abandoned.load(memory_order_acquire))
+            return false;
+        this_thread::yield();
+    }
+    return true;
+}
+void RingBuffer::close(bool failed){
+    header->closed.store(failed ? RingFailed : RingEnded, memory_order_release);
+}
+bool RingBuffer::pop(Instruction& INST){
+    unsigned long long tail = header->tail.load(memory_order_relaxed);
+    if(tail == cachedHead){
+        cachedHead = header->head.load(memory_order_acquire);
+        if(tail == cachedHead)
+            return false;
+    }
+    const Slot& S = slots[tail & (header->capacity-1)];
+    INST = Instruction(S.rd, S.rs, S.rt, S.op);
+    INST.result = S.result;
+    header->tail.store(tail+1, memory_order_release);
+    return true;
+}
+bool RingBuffer::popWait(Instruction& INST){
+    while(!pop(INST)){
+        // anything pushed before close() is still delivered
+        if(header->closed.load(memory_order_acquire) != RingOpen)
+            return pop(INST);
+        this_thread::yield();
+    }
+    return true;
+}
+// Only meaningful once popWait() has returned false
+bool RingBuffer::failed(){
+    return header->closed.load(memory_order_acquire) == RingFailed;
+}
+// Stop reading early; a producer waiting on the full ring gives up
+void RingBuffer::abandon(){
+    header->abandoned.store(1, memory_order_release);
+}
+int RingBuffer::numRegisters(){
+    return header->numRegisters;
+}
+// Remove the shared memory name; mappings stay valid
+void RingBuffer::unlink(){
+    if(!shmName.empty())
+        shm_unlink(shmName.c_str());
+}
+
+RingReader::RingReader(RingBuffer* RING){
+    Ring = RING;
+    error = false;
+}
+bool RingReader::next(Instruction& INST){
+    if(Ring->popWait(INST)){
+        // the slots of a shared ring can hold anything
+        if(INST.op >= AddOp && INST.op <= DivOp)
+            return true;
+        error = true;
+        return false;
+    }
+    error = Ring->failed();
+    return false;
+}
+
+bool produce(InstructionSource* SOURCE, RingBuffer* RING){
+    Instruction INST;
+    while(SOURCE->next(INST))
+        if(!RING->pushWait(INST))
+            return false;
+    return true;
+}
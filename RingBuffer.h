@@ -0,0 +1,91 @@
+//
+// Lock-free single-producer/single-consumer ring of instructions,
+// in process memory or in POSIX shared memory between processes.
+//
+
+#ifndef TOMASULO_RINGBUFFER_H
+#define TOMASULO_RINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include "InstructionSource.h"
+
+// Header::closed
+const int RingOpen = 0;
+const int RingEnded = 1;    // the stream ended normally
+const int RingFailed = -1;  // the producer hit an error, the stream is incomplete
+
+class RingBuffer {
+    public:
+        // One decoded instruction with its resolved result
+        struct Slot {
+            int rd;
+            int rs;
+            int rt;
+            int op;
+            int result;
+        };
+        // Shared between producer and consumer; head and tail sit on
+        // their own cache lines so the two sides do not false-share.
+        struct Header {
+            char magic[8];
+            unsigned long long capacity;    // power of two
+            int numRegisters;               // register file the stream was resolved with
+            alignas(64) std::atomic<unsigned long long> head;   // next slot to write
+            alignas(64) std::atomic<unsigned long long> tail;   // next slot to read
+            alignas(64) std::atomic<int> closed;    // producer is done: RingEnded or RingFailed
+            std::atomic<int> abandoned;             // consumer stopped reading
+        };
+    private:
+        Header* header;
+        Slot* slots;
+        size_t bytes;
+        std::string shmName;    // empty for an in-process ring
+        // Each side's cached copy of the other side's index
+        unsigned long long cachedHead;
+        unsigned long long cachedTail;
+    //**** Methods
+    public:
+        RingBuffer(unsigned long long capacity, int numRegisters);
+        ~RingBuffer();
+        // Shared memory ring, NULL on failure
+        static RingBuffer* create(const char* name, unsigned long long capacity,
+                                  int numRegisters);
+        static RingBuffer* open(const char* name);
+        // Producer side. push() returns false if the ring is full,
+        // pushWait() only once the consumer has abandoned the ring.
+        bool push(const Instruction& INST);
+        bool pushWait(const Instruction& INST);
+        void close(bool failed = false);
+        // Consumer side. pop() returns false if the ring is empty,
+        // popWait() only once it is empty and closed.
+        bool pop(Instruction& INST);
+        bool popWait(Instruction& INST);
+        bool failed();
+        void abandon();
+        int numRegisters();
+        void unlink();
+    private:
+        RingBuffer();
+};
+
+// Consumer end of a ring as an instruction stream
+class RingReader : public InstructionSource {
+    public:
+        RingBuffer* Ring;
+        bool error;         // the stream ended because the producer failed
+                            // or sent an unknown operation
+    //**** Methods
+    public:
+        RingReader(RingBuffer* RING);
+        bool next(Instruction&);
+};
+
+// Drain SOURCE into RING. Producer side of a pipelined run, in its
+// own thread or process. Returns false if the consumer abandoned the
+// ring first. The caller closes the ring, as failed if SOURCE ended
+// on an error.
+bool produce(InstructionSource* SOURCE, RingBuffer* RING);
+
+#endif //TOMASULO_RINGBUFFER_H
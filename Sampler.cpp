@@ -0,0 +1,114 @@
+//
+// Sampled simulation: functional fast-forward with periodic
+// detailed Tomasulo timing windows.
+//
+// Systematic sampling: each period is split into
+//     [ fast-forward ][ warm-up ][ window ]
+// Fast-forward only updates the register file. The warm-up and
+// window instructions run on a cold Tomasulo machine, the warm-up
+// fills the reservation stations and the window is measured as the
+// issue clock distance across it. Total cycles are extrapolated from
+// the mean window CPI.
+//
+
+#include <cmath>
+#include "Sampler.h"
+
+using namespace std;
+
+Sampler::Sampler(){
+    period = 100000;
+    warmup = 200;
+    window = 1000;
+    instructions = 0;
+    detailed = 0;
+    samples = 0;
+    cpiMean = 0;
+    cpiStdDev = 0;
+}
+Sampler::Sampler(long long PERIOD, int WARMUP, int WINDOW){
+    period = PERIOD;
+    warmup = WARMUP;
+    window = WINDOW;
+    instructions = 0;
+    detailed = 0;
+    samples = 0;
+    cpiMean = 0;
+    cpiStdDev = 0;
+}
+// Run SOURCE to the end. CPU gives the architecture and the initial
+// register file, and holds the final register file afterwards.
+// Returns -1 if an instruction uses a register outside the register
+// file, otherwise the number of samples taken.
+int Sampler::run(InstructionSource& SOURCE, Tomasulo& CPU){
+    vector<int> Register = CPU.Thread[0].Register;
+    int numRegisters = Register.size();
+    // warm-up + window + the instruction that closes the window
+    vector<Instruction> Window;
+    // register file at the start of Window
+    vector<int> WindowRegister;
+    Window.reserve(warmup+window+1);
+    long long detailedStart = period - warmup - window;
+    double sum = 0, sumSq = 0;
+    instructions = 0;
+    detailed = 0;
+    samples = 0;
+
+    Instruction INST;
+    while(SOURCE.next(INST)){
+        if(INST.rd < 0 || INST.rd >= numRegisters ||
+           INST.rs < 0 || INST.rs >= numRegisters ||
+           INST.rt < 0 || INST.rt >= numRegisters)
+            return -1;
+        long long offset = instructions % period;
+        if(offset >= detailedStart || (int)Window.size() == warmup+window){
+            if(Window.empty())
+                WindowRegister = Register;
+            Window.push_back(INST);
+            if((int)Window.size() == warmup+window+1){
+                double cpi = measure(CPU, Window, WindowRegister);
+                sum += cpi;
+                sumSq += cpi*cpi;
+                samples++;
+                detailed += Window.size();
+                // closing instruction runs again as part of the next period
+                for(int i=0;i<(int)Window.size()-1;i++)
+                    functionalStep(Window[i], Register);
+                Window.clear();
+            }
+        }
+        if(Window.empty())
+            functionalStep(INST, Register);
+        instructions++;
+    }
+    // a window cut off by the end of the program is not measured
+    for(int i=0;i<(int)Window.size();i++)
+        functionalStep(Window[i], Register);
+
+    cpiMean = samples > 0 ? sum/samples : 0;
+    cpiStdDev = samples > 1 ? sqrt((sumSq - sum*sum/samples)/(samples-1)) : 0;
+    CPU.Thread[0].Register = Register;
+    return samples;
+}
+// Cycles per instruction of the window part of WINDOW, run from
+// register file REGISTER on an empty machine.
+double Sampler::measure(Tomasulo& CPU, const vector<Instruction>& WINDOW,
+                        const vector<int>& REGISTER){
+    CPU.init(REGISTER.size());
+    HardwareThread& T = CPU.Thread[0];
+    T.Register = REGISTER;
+    T.Inst = WINDOW;
+    // stop as soon as the closing instruction has issued
+    while(T.currentInst_ISSUE < (int)WINDOW.size())
+        CPU.cycle();
+    return (double)(T.Inst[warmup+window].issueClock - T.Inst[warmup].issueClock)/window;
+}
+double Sampler::estimatedCycles(){
+    return cpiMean*instructions;
+}
+// Half width of the 95% confidence interval of estimatedCycles()
+double Sampler::confidence95(){
+    if(samples < 2)
+        return 0;
+    return 1.96*cpiStdDev/sqrt((double)samples)*instructions;
+}
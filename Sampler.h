@@ -0,0 +1,38 @@
+//
+// Sampled simulation: functional fast-forward with periodic
+// detailed Tomasulo timing windows.
+//
+
+#ifndef TOMASULO_SAMPLER_H
+#define TOMASULO_SAMPLER_H
+
+#include <vector>
+#include "Tomasulo.h"
+#include "FunctionalEmulator.h"
+
+class Sampler {
+    public:
+        // Every period instructions the last warmup+window are run in
+        // detail; the window instructions are measured.
+        long long period;
+        int warmup;
+        int window;
+        // Results
+        long long instructions;
+        long long detailed;     // instructions run through the timing model
+        int samples;
+        double cpiMean;
+        double cpiStdDev;
+    //**** Methods
+    public:
+        Sampler();
+        Sampler(long long, int, int);
+        int run(InstructionSource& SOURCE, Tomasulo& CPU);
+        double estimatedCycles();
+        double confidence95();
+    private:
+        double measure(Tomasulo& CPU, const std::vector<Instruction>& Window,
+                       const std::vector<int>& Register);
+};
+
+#endif //TOMASULO_SAMPLER_H
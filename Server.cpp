@@ -0,0 +1,357 @@
+//
+// Simulation server: runs jobs sent over a Unix domain socket on a
+// pool of reusable Tomasulo machines and answers in JSON lines.
+//
+
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "Server.h"
+#include "JobOptions.h"
+#include "Trace.h"
+
+using namespace std;
+
+// TEXT as a JSON string
+static string quote(const string& text){
+    string out = "\"";
+    for(int i=0;i<(int)text.size();i++){
+        unsigned char c = text[i];
+        if(c == '"' || c == '\\')
+            out += string("\\") + (char)c;
+        else if(c < 0x20){
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        }
+        else
+            out += (char)c;
+    }
+    return out + "\"";
+}
+static string failure(const string& id, const string& message){
+    string out = "{";
+    if(!id.empty())
+        out += "\"id\":" + quote(id) + ",";
+    return out + "\"ok\":false,\"error\":" + quote(message) + "}";
+}
+static void putRun(ostream& out, long long numInst, int Clock){
+    out << "\"instructions\":" << numInst << ",\"cycles\":" << Clock <<
+           ",\"ipc\":" << fixed << setprecision(6) <<
+           (Clock > 0 ? (double)numInst/Clock : 0.0);
+}
+// Write all of DATA, false once the client is gone
+static bool sendAll(int fd, const string& data){
+    size_t sent = 0;
+    while(sent < data.size()){
+        ssize_t n = send(fd, data.data()+sent, data.size()-sent, MSG_NOSIGNAL);
+        if(n < 0 && errno == EINTR)
+            continue;
+        if(n <= 0)
+            return false;
+        sent += n;
+    }
+    return true;
+}
+
+string runJob(const string& request, Tomasulo& CPU){
+    istringstream words(request);
+    vector<string> arg;
+    string word;
+    while(words >> word)
+        arg.push_back(word);
+
+    //**** Job options, parsed as on the command line
+    JobOptions Job;
+    string id;
+    bool registers = false;
+    bool timing = false;
+    for(int i=0;i<(int)arg.size();i++){
+        // every option except -registers and -timing takes one argument
+        if(arg[i] == "-registers"){
+            registers = true;
+            continue;
+        }
+        if(arg[i] == "-timing"){
+            timing = true;
+            continue;
+        }
+        if(i+1 >= (int)arg.size())
+            return failure(id, "missing value for " + arg[i]);
+        const string& option = arg[i];
+        const char* value = arg[++i].c_str();
+        if(option == "-id"){
+            id = value;
+            continue;
+        }
+        int taken = Job.parse(option.c_str(), value);
+        if(taken == 0)
+            return failure(id, "unknown option " + option);
+        if(taken < 0)
+            return failure(id, "bad value for " + option + ": " + value);
+    }
+    if(!Job.generate && Job.traceIn.empty())
+        return failure(id, "a job needs a program, -n or -t");
+    const char* problem = Job.check();
+    if(problem != NULL)
+        return failure(id, problem);
+
+    //**** Set up the machine
+    CPU.Num_ADD_RS = Job.numRS[0];
+    CPU.Num_MULT_RS = Job.numRS[1];
+    CPU.Num_DIV_RS = Job.numRS[2];
+    CPU.ADD_Lat = Job.lat[0];
+    CPU.MULT_Lat = Job.lat[1];
+    CPU.DIV_Lat = Job.lat[2];
+    CPU.scheduler = Job.unifiedRS > 0 ? UnifiedRS : PartitionedRS;
+    CPU.Num_RS = Job.unifiedRS > 0 ? Job.unifiedRS : Job.numRS[0]+Job.numRS[1]+Job.numRS[2];
+    CPU.ADD_Cap = Job.cap[0];
+    CPU.MULT_Cap = Job.cap[1];
+    CPU.DIV_Cap = Job.cap[2];
+    CPU.issuePolicy = Job.issuePolicy;
+    CPU.resolvedValues = false;
+    // only -timing reports every instruction
+    CPU.keepRetired = timing;
+    CPU.CDB = NULL;
+    CPU.init(Job.Generator.regPool, Job.numSMT);
+    // every thread streams its own copy of the program
+    // (generated programs use seed, seed+1, ...)
+    deque<TraceReader> Traces;
+    vector<WorkloadGenerator> Generators(Job.numSMT, Job.Generator);
+    for(int t=0;t<Job.numSMT;t++){
+        if(!Job.traceIn.empty()){
+            Traces.emplace_back(Job.traceIn.c_str());
+            if(!Traces.back().is_open())
+                return failure(id, "cannot open trace file " + Job.traceIn);
+            CPU.Thread[t].Source = &Traces.back();
+        }
+        else{
+            Generators[t].seed = Job.Generator.seed + t;
+            Generators[t].reset();
+            CPU.Thread[t].Source = &Generators[t];
+        }
+    }
+
+    //**** Run
+    while(!CPU.done()){
+        int status = CPU.cycle();
+        if(status == -2)
+            return failure(id, "the run needs more than " + to_string(INT_MAX) + " cycles");
+        if(status < 0)
+            return failure(id, "thread " + to_string(CPU.faultThread) + ": instruction " +
+                           to_string(CPU.Thread[CPU.faultThread].numInstructions()) +
+                           " uses a register outside F0-F" +
+                           to_string(Job.Generator.regPool-1) + " (see -regs)");
+    }
+    for(int t=0;t<(int)Traces.size();t++)
+        if(Traces[t].error)
+            return failure(id, Traces[t].path + ":" + to_string(Traces[t].line) +
+                           ": malformed instruction");
+
+    //**** Result
+    ostringstream out;
+    long long instructions = 0;
+    for(int t=0;t<Job.numSMT;t++)
+        instructions += CPU.Thread[t].numInstructions();
+    out << "{";
+    if(!id.empty())
+        out << "\"id\":" << quote(id) << ",";
+    out << "\"ok\":true,";
+    putRun(out, instructions, CPU.Clock);
+    out << ",\"threads\":[";
+    for(int t=0;t<Job.numSMT;t++){
+        const vector<Instruction>& INST = CPU.Thread[t].Inst;
+        out << (t > 0 ? ",{" : "{");
+        putRun(out, CPU.Thread[t].numInstructions(), CPU.Thread[t].lastWriteback());
+        if(registers){
+            const vector<int>& Register = CPU.Thread[t].Register;
+            out << ",\"registers\":[";
+            for(int x=0;x<(int)Register.size();x++)
+                out << (x > 0 ? "," : "") << Register[x];
+            out << "]";
+        }
+        // issue, execute begin, execute end, writeback
+        if(timing){
+            out << ",\"timing\":[";
+            for(int i=0;i<(int)INST.size();i++)
+                out << (i > 0 ? ",[" : "[") << INST[i].issueClock << "," <<
+                       INST[i].executeClockBegin << "," << INST[i].executeClockEnd <<
+                       "," << INST[i].writebackClock << "]";
+            out << "]";
+        }
+        out << "}";
+    }
+    out << "]}";
+    return out.str();
+}
+
+Server::Server(const char* PATH, int NUMWORKERS){
+    path = PATH;
+    numWorkers = NUMWORKERS;
+    listenFd = -1;
+    stopping = false;
+}
+bool Server::open(){
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if(path.size() >= sizeof(addr.sun_path))
+        return false;
+    strcpy(addr.sun_path, path.c_str());
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listenFd < 0)
+        return false;
+    // replace a socket left behind by an earlier server,
+    // never any other kind of file
+    struct stat st;
+    if(lstat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode))
+        unlink(path.c_str());
+    if(bind(listenFd, (sockaddr*)&addr, sizeof(addr)) < 0 ||
+       listen(listenFd, SOMAXCONN) < 0){
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    return true;
+}
+void Server::run(){
+    vector<thread> Workers;
+    for(int w=0;w<numWorkers;w++)
+        Workers.push_back(thread(&Server::work, this));
+    // one thread per client, it waits while a worker runs its job
+    while(true){
+        int fd = accept(listenFd, NULL, NULL);
+        reap();
+        unique_lock<mutex> guard(lock);
+        if(stopping){
+            if(fd >= 0)
+                close(fd);
+            break;
+        }
+        if(fd >= 0){
+            clientFds.insert(fd);
+            Clients.push_back(thread(&Server::serve, this, fd));
+        }
+    }
+    for(int w=0;w<numWorkers;w++)
+        Workers[w].join();
+    for(int c=0;c<(int)Clients.size();c++)
+        Clients[c].join();
+    close(listenFd);
+    unlink(path.c_str());
+}
+// Answer the requests of one client until it disconnects
+void Server::serve(int fd){
+    string buffer;
+    char chunk[4096];
+    while(true){
+        size_t end = buffer.find('\n');
+        if(end == string::npos){
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if(n < 0 && errno == EINTR)
+                continue;
+            if(n <= 0)
+                break;
+            buffer.append(chunk, n);
+            continue;
+        }
+        string request = buffer.substr(0, end);
+        buffer.erase(0, end+1);
+        if(!request.empty() && request[request.size()-1] == '\r')
+            request.erase(request.size()-1);
+        if(request.find_first_not_of(" \t") == string::npos)
+            continue;
+        if(request == "shutdown"){
+            sendAll(fd, "{\"ok\":true}\n");
+            stop();
+            break;
+        }
+        Job job;
+        job.request = request;
+        job.done = false;
+        {
+            unique_lock<mutex> guard(lock);
+            if(stopping)
+                job.response = failure("", "server is shutting down");
+            else{
+                Queue.push_back(&job);
+                queued.notify_one();
+                finished.wait(guard, [&job](){ return job.done; });
+            }
+        }
+        if(!sendAll(fd, job.response + "\n"))
+            break;
+    }
+    // under the lock, so stop() never shuts down a reused fd
+    lock_guard<mutex> guard(lock);
+    clientFds.erase(fd);
+    close(fd);
+    finishedClients.push_back(this_thread::get_id());
+}
+// Worker: run queued jobs on one machine, reused from job to job
+void Server::work(){
+    Tomasulo CPU;
+    while(true){
+        Job* job;
+        {
+            unique_lock<mutex> guard(lock);
+            queued.wait(guard, [this](){ return stopping || !Queue.empty(); });
+            // finish the queued jobs before stopping
+            if(Queue.empty())
+                return;
+            job = Queue.front();
+            Queue.pop_front();
+        }
+        string response;
+        // a job that fails in the simulator (e.g. out of memory)
+        // fails alone, the machine is rebuilt for the next one
+        try{
+            response = runJob(job->request, CPU);
+        }
+        catch(const exception& e){
+            response = failure("", string("job failed: ") + e.what());
+            CPU = Tomasulo();
+        }
+        lock_guard<mutex> guard(lock);
+        job->response = response;
+        job->done = true;
+        finished.notify_all();
+    }
+}
+void Server::stop(){
+    lock_guard<mutex> guard(lock);
+    stopping = true;
+    queued.notify_all();
+    // wakes run() out of accept() and the clients out of recv();
+    // answers to jobs already queued can still be sent
+    shutdown(listenFd, SHUT_RDWR);
+    for(set<int>::iterator fd=clientFds.begin();fd!=clientFds.end();fd++)
+        shutdown(*fd, SHUT_RD);
+}
+// Join the client threads that have finished
+void Server::reap(){
+    vector<thread::id> done;
+    {
+        lock_guard<mutex> guard(lock);
+        done.swap(finishedClients);
+    }
+    for(int f=0;f<(int)done.size();f++){
+        for(int c=0;c<(int)Clients.size();c++){
+            if(Clients[c].get_id() == done[f]){
+                Clients[c].join();
+                Clients.erase(Clients.begin()+c);
+                break;
+            }
+        }
+    }
+}
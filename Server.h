@@ -0,0 +1,65 @@
+//
+// Simulation server: runs jobs sent over a Unix domain socket on a
+// pool of reusable Tomasulo machines and answers in JSON lines.
+//
+
+#ifndef TOMASULO_SERVER_H
+#define TOMASULO_SERVER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Tomasulo.h"
+
+// Protocol: one request per line, one response line per request, in
+// order. A request is a job in command line syntax,
+//     -id sweep7 -n 100000 -seed 3 -rs 2,1,1 -lat 4,12,38 -registers
+// accepting the JobOptions -n -mix -dep -regs -seed -t -rs -lat -unified
+// -cap -smt -issue, and the output options -id TEXT (echoed back), -registers
+// (final register files) and -timing (per instruction clocks). The
+// response is a JSON object, "ok":false with an "error" on failure.
+// The request "shutdown" stops the server.
+class Server {
+    public:
+        std::string path;
+        int numWorkers;
+    private:
+        struct Job {
+            std::string request;
+            std::string response;
+            bool done;
+        };
+        int listenFd;
+        bool stopping;
+        std::mutex lock;
+        std::condition_variable queued;
+        std::condition_variable finished;
+        std::deque<Job*> Queue;
+        // client connections: the open sockets (shut down on stop),
+        // one thread each, and those threads once they have finished
+        std::set<int> clientFds;
+        std::vector<std::thread> Clients;
+        std::vector<std::thread::id> finishedClients;
+    //**** Methods
+    public:
+        Server(const char* PATH, int NUMWORKERS);
+        // Create and listen on the socket, replacing a stale one
+        bool open();
+        // Serve until a shutdown request, then remove the socket
+        // once every client and worker thread has ended
+        void run();
+    private:
+        void serve(int fd);
+        void work();
+        void stop();
+        void reap();
+};
+
+// Run one request on CPU and return the JSON response
+std::string runJob(const std::string& request, Tomasulo& CPU);
+
+#endif //TOMASULO_SERVER_H
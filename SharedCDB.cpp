@@ -0,0 +1,47 @@
+//
+// Common data bus shared by several Tomasulo cores.
+//
+
+#include <climits>
+#include <thread>
+#include "SharedCDB.h"
+
+SharedCDB::SharedCDB(int WIDTH, int QUANTUM, int NUMCORES) : conflicts(0) {
+    width = WIDTH;
+    quantum = QUANTUM;
+    window = QUANTUM;
+    numCores = NUMCORES;
+    used.reset(new std::atomic<int>[window]);
+    for(int i=0;i<window;i++)
+        used[i].store(0);
+    progress.reset(new std::atomic<int>[numCores]);
+    for(int c=0;c<numCores;c++)
+        progress[c].store(0);
+}
+// Claim a broadcast slot in cycle clock for core. Waits
+// until the lower-numbered cores have claimed theirs.
+bool SharedCDB::acquire(int core, int clock){
+    for(int c=0;c<core;c++)
+        while(progress[c].load(std::memory_order_acquire) < clock)
+            std::this_thread::yield();
+    if(used[clock % window].load(std::memory_order_relaxed) < width){
+        used[clock % window].fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    conflicts.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+// core is done with cycle clock, higher cores may claim its slots
+void SharedCDB::release(int core, int clock){
+    progress[core].store(clock, std::memory_order_release);
+}
+// core will not use the bus again
+void SharedCDB::finish(int core){
+    progress[core].store(INT_MAX, std::memory_order_release);
+}
+// Forget the cycles of the quantum that ended. Only called while
+// every core is stopped at a barrier.
+void SharedCDB::clear(){
+    for(int i=0;i<window;i++)
+        used[i].store(0, std::memory_order_relaxed);
+}
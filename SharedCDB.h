@@ -0,0 +1,40 @@
+//
+// Common data bus shared by several Tomasulo cores.
+//
+
+#ifndef TOMASULO_SHAREDCDB_H
+#define TOMASULO_SHAREDCDB_H
+
+#include <atomic>
+#include <memory>
+
+// Carries at most width results per cycle for all cores together.
+// Slots go by fixed priority, lower-numbered cores first: a core
+// claims its slots of a cycle only once every lower core has
+// finished that cycle's WRITEBACK. The grants depend only on the
+// simulated state, never on how the cores are spread over host
+// threads or how fast those run.
+// All cores run the same quantum between two barriers, so the bus
+// keeps a use count for each cycle of one quantum and clears them
+// at the barrier that ends it.
+class SharedCDB {
+    public:
+        int width;
+        int quantum;
+        std::atomic<long long> conflicts;   // results that had to wait a cycle
+    private:
+        int window;
+        int numCores;
+        std::unique_ptr<std::atomic<int>[]> used;
+        // per core: last clock whose WRITEBACK is finished
+        std::unique_ptr<std::atomic<int>[]> progress;
+    //**** Methods
+    public:
+        SharedCDB(int width, int quantum, int numCores);
+        bool acquire(int core, int clock);
+        void release(int core, int clock);
+        void finish(int core);
+        void clear();
+};
+
+#endif //TOMASULO_SHAREDCDB_H
@@ -0,0 +1,629 @@
+//
+// Tomasulo machine: architecture, machine state and datapath.
+//
+
+#include <climits>
+#include <cstddef>
+#include "Tomasulo.h"
+#include "Profile.h"
+
+using namespace std;
+
+// Written-back instructions dropped at once (see dropRetired)
+static const int RetireBatch = 4096;
+
+Tomasulo::Tomasulo(){
+    Num_ADD_RS = 4;
+    Num_MULT_RS = 2;
+    Num_DIV_RS = 3;
+    ADD_Lat = 4;
+    MULT_Lat = 12;
+    DIV_Lat = 38;
+    scheduler = PartitionedRS;
+    Num_RS = Num_ADD_RS+Num_MULT_RS+Num_DIV_RS;
+    ADD_Cap = 0;
+    MULT_Cap = 0;
+    DIV_Cap = 0;
+    issuePolicy = RoundRobinIssue;
+    resolvedValues = false;
+    keepRetired = true;
+    CDB = NULL;
+    core = 0;
+    init(13);
+}
+// Reset the machine state: numThreads threads with an empty
+// program and a register file of numRegisters registers with
+// F0 = ZERO_REG, Fi = i, and idle reservation stations laid out
+// ADD, MULT then DIV (Num_RS stations and free ports if unified).
+void Tomasulo::init(int numRegisters, int numThreads){
+    Clock = 0;
+    // keep the vectors' storage, a reused machine (see Server)
+    // does not reallocate for every run
+    Thread.resize(numThreads);
+    for(int t=0;t<numThreads;t++){
+        HardwareThread& T = Thread[t];
+        T.currentInst_ISSUE = 0;
+        T.Total_WRITEBACKS = 0;
+        T.Inst.clear();
+        T.retired = 0;
+        T.retiredWriteback = 0;
+        T.Source = NULL;
+        T.RegStatus.assign(numRegisters, RegisterStatus(RegStatusEmpty));
+        T.Register.resize(numRegisters);
+        T.Register[0] = ZERO_REG;
+        for(int i=1;i<numRegisters;i++)
+            T.Register[i] = i;
+    }
+    // thread 0 issues first
+    lastIssued = numThreads-1;
+    faultThread = 0;
+    ResStation.clear();
+    Port.clear();
+    if(scheduler == UnifiedRS){
+        ResStation.assign(Num_RS, ReservationStation(AddOp, OperandInit));
+        Port.assign(Num_ADD_RS+Num_MULT_RS+Num_DIV_RS, -1);
+        return;
+    }
+    for(int i=0;i<Num_ADD_RS;i++)
+        ResStation.push_back(ReservationStation(AddOp, OperandInit));
+    for(int i=0;i<Num_MULT_RS;i++)
+        ResStation.push_back(ReservationStation(MultOp, OperandInit));
+    for(int i=0;i<Num_DIV_RS;i++)
+        ResStation.push_back(ReservationStation(DivOp, OperandInit));
+}
+// Change the architecture of a running machine (e.g. one restored
+// from a checkpoint). Stations keep their position within their
+// class and all tags are renumbered. Fails without changing anything
+// if a busy station would be removed. A unified pool stays as it is,
+// the counts change its ports, which must not drop a busy one.
+bool Tomasulo::reconfigure(int numAdd, int numMult, int numDiv,
+                           int addLat, int multLat, int divLat){
+    const int classOp[3] = {AddOp, MultOp, DivOp};
+    const int oldStart[3] = {0, Num_ADD_RS, Num_ADD_RS+Num_MULT_RS};
+    const int oldCount[3] = {Num_ADD_RS, Num_MULT_RS, Num_DIV_RS};
+    const int newStart[3] = {0, numAdd, numAdd+numMult};
+    const int newCount[3] = {numAdd, numMult, numDiv};
+    // old station number -> new station number
+    vector<int> tag(ResStation.size(), -1);
+    vector<ReservationStation> NewResStation;
+    vector<int> NewPort;
+    for(int c=0;c<3 && scheduler == UnifiedRS;c++){
+        for(int k=0;k<newCount[c];k++)
+            NewPort.push_back(k < oldCount[c] ? Port[oldStart[c]+k] : -1);
+        for(int k=newCount[c];k<oldCount[c];k++)
+            if(Port[oldStart[c]+k] >= 0)
+                return false;
+    }
+    if(scheduler == UnifiedRS){
+        for(int r=0;r<(int)ResStation.size();r++)
+            tag[r] = r;
+        NewResStation = ResStation;
+        for(int p=0;p<(int)NewPort.size();p++)
+            if(NewPort[p] >= 0)
+                NewResStation[NewPort[p]].port = p;
+    }
+    for(int c=0;c<3 && scheduler == PartitionedRS;c++){
+        for(int k=0;k<newCount[c];k++)
+            NewResStation.push_back(ReservationStation(classOp[c], OperandInit));
+        for(int k=0;k<oldCount[c];k++){
+            if(k < newCount[c]){
+                tag[oldStart[c]+k] = newStart[c]+k;
+                NewResStation[newStart[c]+k] = ResStation[oldStart[c]+k];
+            }
+            else if(ResStation[oldStart[c]+k].busy)
+                return false;
+        }
+    }
+    for(int r=0;r<(int)NewResStation.size();r++){
+        ReservationStation& RS = NewResStation[r];
+        if(RS.Qj >= 0 && RS.Qj < (int)tag.size())
+            RS.Qj = tag[RS.Qj];
+        if(RS.Qk >= 0 && RS.Qk < (int)tag.size())
+            RS.Qk = tag[RS.Qk];
+        // an operation already past the new latency
+        // finishes on the next cycle
+        int lat = RS.op == MultOp ? multLat : RS.op == DivOp ? divLat : addLat;
+        if(RS.busy && RS.lat >= lat)
+            RS.lat = lat-1;
+    }
+    for(int t=0;t<(int)Thread.size();t++){
+        vector<RegisterStatus>& RegStatus = Thread[t].RegStatus;
+        for(int x=0;x<(int)RegStatus.size();x++)
+            if(RegStatus[x].Qi >= 0 && RegStatus[x].Qi < (int)tag.size())
+                RegStatus[x].Qi = tag[RegStatus[x].Qi];
+    }
+
+    ResStation = NewResStation;
+    Port = NewPort;
+    Num_ADD_RS = numAdd;
+    Num_MULT_RS = numMult;
+    Num_DIV_RS = numDiv;
+    ADD_Lat = addLat;
+    MULT_Lat = multLat;
+    DIV_Lat = divLat;
+    return true;
+}
+// One system clock cycle. Returns -1 if a streamed instruction
+// uses a register outside the register file (see faultThread),
+// -2 if Clock (an int, as are the instruction clocks) cannot count
+// another cycle.
+int Tomasulo::cycle(){
+    if(Clock == INT_MAX)
+        return -2;
+    Clock++; // system clock
+    {
+        PROFILE_SCOPE(ProfileFetch);
+        for(int t=0;t<(int)Thread.size();t++){
+            if(fetch(Thread[t]) < 0){
+                faultThread = t;
+                return -1;
+            }
+        }
+    }
+    ISSUE();
+    EXECUTE();
+    WRITEBACK();
+    if(CDB != NULL)
+        CDB->release(core, Clock);
+    if(!keepRetired)
+        for(int t=0;t<(int)Thread.size();t++)
+            dropRetired(t);
+    return 0;
+}
+// Program is done once every instruction of every
+// thread has been written back
+// TODO: if LW/SW are added this will need to be udated
+bool Tomasulo::done(){
+    for(int t=0;t<(int)Thread.size();t++)
+        if(!Thread[t].done())
+            return false;
+    return true;
+}
+// Pull the next streamed instruction of thread T once
+// the previous one has been issued
+int Tomasulo::fetch(HardwareThread& T){
+    if(T.Source == NULL || T.currentInst_ISSUE < (int)T.Inst.size())
+        return 0;
+    Instruction next;
+    if(!T.Source->next(next)){
+        T.Source = NULL;
+        return 0;
+    }
+    int numRegisters = T.Register.size();
+    if(next.rd < 0 || next.rd >= numRegisters ||
+       next.rs < 0 || next.rs >= numRegisters ||
+       next.rt < 0 || next.rt >= numRegisters)
+        return -1;
+    T.Inst.push_back(next);
+    return 1;
+}
+// Drop thread t's written-back instructions in front of its oldest
+// instruction still in a station, RetireBatch/2 or more at a time
+// so the copy is amortized. The issue and writeback counters and
+// the stations' instNum move down with Inst.
+void Tomasulo::dropRetired(int t){
+    HardwareThread& T = Thread[t];
+    if(T.Total_WRITEBACKS < RetireBatch)
+        return;
+    int oldest = T.currentInst_ISSUE;
+    for(int r=0;r<(int)ResStation.size();r++)
+        if(ResStation[r].busy && ResStation[r].thread == t && ResStation[r].instNum < oldest)
+            oldest = ResStation[r].instNum;
+    if(oldest < RetireBatch/2)
+        return;
+    for(int i=0;i<oldest;i++)
+        if(T.Inst[i].writebackClock > T.retiredWriteback)
+            T.retiredWriteback = T.Inst[i].writebackClock;
+    T.Inst.erase(T.Inst.begin(), T.Inst.begin()+oldest);
+    T.currentInst_ISSUE -= oldest;
+    T.Total_WRITEBACKS -= oldest;
+    T.retired += oldest;
+    for(int r=0;r<(int)ResStation.size();r++)
+        if(ResStation[r].busy && ResStation[r].thread == t)
+            ResStation[r].instNum -= oldest;
+}
+
+//#######################################################################
+// Datapath FUNCTIONS
+// Offer the single issue slot to the threads in issuePolicy order,
+// the first one that finds a free reservation station issues.
+// Returns 2 if an instruction issued, 1 if a thread was stalled
+// on a full reservation station, 0 if there was nothing to issue.
+int Tomasulo::ISSUE(){
+    PROFILE_SCOPE(ProfileIssue);
+    int numThreads = Thread.size();
+    if(numThreads == 1)
+        return issue(0);
+    // round-robin order, starting after the last thread to issue
+    vector<int> order(numThreads);
+    for(int k=0;k<numThreads;k++)
+        order[k] = (lastIssued+1+k) % numThreads;
+    if(issuePolicy == ICountIssue){
+        // fewest instructions in flight first, ties in round-robin order
+        vector<int> inFlight(numThreads, 0);
+        for(int r=0;r<(int)ResStation.size();r++)
+            if(ResStation[r].busy)
+                inFlight[ResStation[r].thread]++;
+        for(int k=1;k<numThreads;k++){
+            int t = order[k];
+            int j = k;
+            for(;j>0 && inFlight[order[j-1]] > inFlight[t];j--)
+                order[j] = order[j-1];
+            order[j] = t;
+        }
+    }
+    int status = 0;
+    for(int k=0;k<numThreads;k++){
+        int rc = issue(order[k]);
+        if(rc == 2){
+            lastIssued = order[k];
+            return 2;
+        }
+        if(rc > status)
+            status = rc;
+    }
+    return status;
+}//END ISSUE()
+// Issue the next instruction of thread t
+int Tomasulo::issue(int t){
+    HardwareThread& T = Thread[t];
+    vector<Instruction>& Inst = T.Inst;
+    int& currentInst_ISSUE = T.currentInst_ISSUE;
+    // Latency of 1 if issued
+    //**** check if spot in given reservation station is available
+    int r = 0;
+    bool rsFree = false;
+    // r is the current instruction to be issued's operation
+    // code(add,sub,mult,div)
+    // If all instructions have been issued then stop issueing
+    // for rest of program
+    if(currentInst_ISSUE >= (int)Inst.size())
+            return 0;
+    r = Inst[currentInst_ISSUE].op;
+    // determine if there is an open RS of r type. if yes
+    // -> r = that open spot.
+    // Boundry's of given RS
+    int RSAddStart = Num_ADD_RS-Num_ADD_RS;
+    int RSAddEnd = Num_ADD_RS;
+    int RSSubStart = Num_ADD_RS-Num_ADD_RS;
+    int RSSubEnd = Num_ADD_RS;
+    int RSMulStart = Num_ADD_RS;
+    int RSMulEnd = Num_ADD_RS+Num_MULT_RS;
+    int RSDivStart = Num_ADD_RS+Num_MULT_RS;
+    int RSDivEnd = Num_ADD_RS+Num_MULT_RS+Num_DIV_RS;
+    if(scheduler == UnifiedRS){
+        // any station takes any op as long as the
+        // class stays within its cap
+        int cap = r == MultOp ? MULT_Cap : r == DivOp ? DIV_Cap : ADD_Cap;
+        int inUse = 0;
+        PROFILE_COUNT(ProfileIssueScan, ResStation.size());
+        for(int i=0;i<(int)ResStation.size();i++)
+            if(ResStation[i].busy &&
+               (ResStation[i].op == r || (r <= SubOp && ResStation[i].op <= SubOp)))
+                inUse++;
+        if(cap > 0 && inUse >= cap)
+            return 1;
+        RSAddStart = RSSubStart = RSMulStart = RSDivStart = 0;
+        RSAddEnd = RSSubEnd = RSMulEnd = RSDivEnd = ResStation.size();
+    }
+    switch(r){
+        case AddOp:
+            for(int i=RSAddStart;i<RSAddEnd;i++){
+                PROFILE_COUNT(ProfileIssueScan, 1);
+                if(!ResStation[i].busy){
+                    r = i;
+                    currentInst_ISSUE++;
+                    ResStation[i].op = AddOp;
+                    rsFree = true;
+                    break;
+                }
+            }
+            // if instruction is not issued because no
+            // reservation stations are free exit ISSUE
+            // Init is not necessary if instruction not issued
+            if(!rsFree)
+                return 1;
+            break;
+        case SubOp:
+            for(int i=RSSubStart;i<RSSubEnd;i++){
+                PROFILE_COUNT(ProfileIssueScan, 1);
+                if(!ResStation[i].busy){
+                    r = i;
+                    currentInst_ISSUE++;
+                    ResStation[i].op = SubOp;
+                    rsFree = true;
+                    break;
+                }
+            }
+            if(!rsFree)
+                return 1;
+            break;
+        case MultOp:
+            for(int i=RSMulStart;i<RSMulEnd;i++){
+                PROFILE_COUNT(ProfileIssueScan, 1);
+                if(!ResStation[i].busy){
+                    r = i;
+                    currentInst_ISSUE++;
+                    ResStation[i].op = MultOp;
+                    rsFree = true;
+                    break;
+                }
+            }
+            if(!rsFree)
+                return 1;
+            break;
+        case DivOp:
+            for(int i=RSDivStart;i<RSDivEnd;i++){
+                PROFILE_COUNT(ProfileIssueScan, 1);
+                if(!ResStation[i].busy){
+                    r = i;
+                    currentInst_ISSUE++;
+                    ResStation[i].op = DivOp;
+                    rsFree = true;
+                    break;
+                }
+            }
+            if(!rsFree)
+                return 1;
+            break;
+        default:
+            break;
+    }
+    //**** Initialize characteristics of issued instruction
+    // if operand rs is available -> set value of operand
+    // (Vj) to given register value
+    // else point operand to the reservation station (Qj)
+    // that will give the operand value
+    // NOTE: since currentInst was in incremented we must
+    // do currentINST_ISSUE-1
+    vector<RegisterStatus>& RegStatus = T.RegStatus;
+    vector<int>& Register = T.Register;
+    if(RegStatus[Inst[currentInst_ISSUE-1].rs].Qi == RegStatusEmpty){
+        ResStation[r].Vj = Register[Inst[currentInst_ISSUE-1].rs];
+        ResStation[r].Qj = OperandAvailable;
+    }
+    else{
+        ResStation[r].Qj = RegStatus[Inst[currentInst_ISSUE-1].rs].Qi;
+    }
+    // if operand rt is available -> set value of
+    // operand (Vk) to given register value
+    // else point operand to the reservation station
+    // (Qk) that will give the operand value
+    if(RegStatus[Inst[currentInst_ISSUE-1].rt].Qi == RegStatusEmpty){
+        ResStation[r].Vk = Register[Inst[currentInst_ISSUE-1].rt];
+        ResStation[r].Qk = OperandAvailable;
+    }
+    else{
+        ResStation[r].Qk = RegStatus[Inst[currentInst_ISSUE-1].rt].Qi;
+    }
+    // given reservation station is now busy
+    // until write back stage is completed.
+    ResStation[r].busy = true;
+    ResStation[r].ISSUE_Lat = 0;
+    // set reservation station instuction
+    // number == current instruction
+    ResStation[r].instNum = currentInst_ISSUE-1;
+    ResStation[r].thread = t;
+    // set clock cycle for issue time
+    Inst[currentInst_ISSUE-1].issueClock = Clock;
+    // The register status Qi is set to the current
+    // instructions reservation station location r
+    RegStatus[Inst[currentInst_ISSUE-1].rd].Qi = r;
+    return 2;
+}//END issue()
+void Tomasulo::EXECUTE(){
+    PROFILE_SCOPE(ProfileExecute);
+    PROFILE_COUNT(ProfileExecuteScan, ResStation.size());
+    // check each reservation station to see
+    // if both operands are ready
+    // The current reservation station is r
+    for (int r=0;r<(int)ResStation.size();r++){
+        // if both operands are available then
+        // execute given instructions operation
+        // and set resultReady flag to true so that
+        // result can be written back to CDB
+        // first check if instruction has been issued
+        // (and is not just waiting for the CDB)
+        if(ResStation[r].busy == true && !ResStation[r].resultReady){
+            vector<Instruction>& Inst = Thread[ResStation[r].thread].Inst;
+            // second check if the ISSUE latency clock cycle has happened
+            if(ResStation[r].ISSUE_Lat >= ISSUE_Lat){
+                // third check if both operands are available
+                if(ResStation[r].Qj == OperandAvailable &&
+                        ResStation[r].Qk == OperandAvailable){
+                    // A unified station first needs a free unit
+                    // of its class, else it waits
+                    if(scheduler == UnifiedRS && ResStation[r].port < 0 && !bindPort(r))
+                        continue;
+                    // Set clock cycle when execution begins
+                    if(Inst[ResStation[r].instNum].executeClockBegin == 0)
+                        Inst[ResStation[r].instNum].executeClockBegin = Clock;
+                    // when execution starts we must wait the given
+                    // latency number of clock cycles before making result
+                    // available to WriteBack
+                    // Delay: Switch(Inst.op)
+                    //		case(add): 	clock += 4;
+                    //		case(mult): 	clock += 12;
+                    //		case(div):	clock += 38;
+                    ResStation[r].lat++;
+                    switch(ResStation[r].op){
+                        case(AddOp):
+                            if(ResStation[r].lat == ADD_Lat){
+                                if(resolvedValues)
+                                    ResStation[r].result = Inst[ResStation[r].instNum].result;
+                                else
+                                    // wraps around in unsigned, signed overflow is undefined
+                                    ResStation[r].result = (int)((unsigned)ResStation[r].Vj +
+                                                                 (unsigned)ResStation[r].Vk);
+                                // Result is ready to be writenback
+                                ResStation[r].resultReady = true;
+                                ResStation[r].lat = 0;
+                                // Set clock cycle when execution ends
+                                Inst[ResStation[r].instNum].executeClockEnd = Clock;
+                                // reset ISSUE latency for RS
+                                ResStation[r].ISSUE_Lat = 0;
+                            }
+                            break;
+                        case(SubOp):
+                            if(ResStation[r].lat == ADD_Lat){
+                                if(resolvedValues)
+                                    ResStation[r].result = Inst[ResStation[r].instNum].result;
+                                else
+                                    ResStation[r].result = (int)((unsigned)ResStation[r].Vj -
+                                                                 (unsigned)ResStation[r].Vk);
+                                ResStation[r].resultReady = true;
+                                ResStation[r].lat = 0;
+                                // Set clock cycle when execution ends
+                                Inst[ResStation[r].instNum].executeClockEnd = Clock;
+                                // reset ISSUE latency for RS
+                                ResStation[r].ISSUE_Lat = 0;
+                            }
+                            break;
+                        case(MultOp):
+                            if(ResStation[r].lat == MULT_Lat){
+                                if(resolvedValues)
+                                    ResStation[r].result = Inst[ResStation[r].instNum].result;
+                                else
+                                    ResStation[r].result = (int)((unsigned)ResStation[r].Vj *
+                                                                 (unsigned)ResStation[r].Vk);
+                                ResStation[r].resultReady = true;
+                                ResStation[r].lat = 0;
+                                // Set clock cycle when execution ends
+                                Inst[ResStation[r].instNum].executeClockEnd = Clock;
+                                // reset ISSUE latency for RS
+                                ResStation[r].ISSUE_Lat = 0;
+                            }
+                            break;
+                        case(DivOp):
+                            if(ResStation[r].lat == DIV_Lat){
+                                if(resolvedValues)
+                                    ResStation[r].result = Inst[ResStation[r].instNum].result;
+                                // Generated programs can divide by zero (or
+                                // overflow INT_MIN/-1), the result is 0
+                                else if(ResStation[r].Vk == 0 ||
+                                   (ResStation[r].Vk == -1 && ResStation[r].Vj == INT_MIN))
+                                    ResStation[r].result = 0;
+                                else
+                                    ResStation[r].result = ResStation[r].Vj / ResStation[r].Vk;
+                                ResStation[r].resultReady = true;
+                                ResStation[r].lat = 0;
+                                // Set clock cycle when execution ends
+                                Inst[ResStation[r].instNum].executeClockEnd = Clock;
+                                // reset ISSUE latency for RS
+                                ResStation[r].ISSUE_Lat = 0;
+                            }
+                            break;
+                        default:
+                            break;
+                    }
+                    // the unit is free again once the result is ready
+                    if(ResStation[r].resultReady && ResStation[r].port >= 0){
+                        Port[ResStation[r].port] = -1;
+                        ResStation[r].port = -1;
+                    }
+                }
+            }
+            else // Execute is not ready until one cycle latency of ISSUE
+                ResStation[r].ISSUE_Lat++;
+        }
+
+    }
+
+}//END EXECUTE()
+// Unified scheduler: bind station r to a free port of its
+// op class. Returns false if every unit of the class is busy.
+bool Tomasulo::bindPort(int r){
+    int start = 0;
+    int end = Num_ADD_RS;
+    if(ResStation[r].op == MultOp){
+        start = Num_ADD_RS;
+        end = Num_ADD_RS+Num_MULT_RS;
+    }
+    else if(ResStation[r].op == DivOp){
+        start = Num_ADD_RS+Num_MULT_RS;
+        end = Num_ADD_RS+Num_MULT_RS+Num_DIV_RS;
+    }
+    for(int p=start;p<end;p++){
+        if(Port[p] < 0){
+            Port[p] = r;
+            ResStation[r].port = p;
+            return true;
+        }
+    }
+    return false;
+}
+void Tomasulo::WRITEBACK(){
+    PROFILE_SCOPE(ProfileWriteback);
+    PROFILE_COUNT(ProfileWritebackScan, ResStation.size());
+    // Check each reservation station to see
+    // if operational delay is done -> result is ready
+    for(int r=0;r<(int)ResStation.size();r++){
+        // if result ready write back to CDB
+        // -> Register,and reservation stations
+        if(ResStation[r].resultReady){
+            // Before Writeback is available there
+            // must be a 1 cycle WB delay
+            if(ResStation[r].WRITEBACK_Lat == WRITEBACK_Lat){
+                // A shared CDB may be taken by other cores
+                // this cycle -> try again next cycle
+                if(CDB != NULL && !CDB->acquire(core, Clock))
+                    continue;
+                // the result belongs to the thread that issued it
+                HardwareThread& T = Thread[ResStation[r].thread];
+                vector<Instruction>& Inst = T.Inst;
+                vector<RegisterStatus>& RegStatus = T.RegStatus;
+                vector<int>& Register = T.Register;
+                // set clock cycle when write back occured.
+                // (Must add one because increment happens after loop)
+                if(Inst[ResStation[r].instNum].writebackClock == 0)
+                    Inst[ResStation[r].instNum].writebackClock = Clock;
+                // Check if any registers (via the registerStatus)
+                // are waiting for current r result
+                PROFILE_COUNT(ProfileRegisterScan, Register.size());
+                for(int x=0;x<(int)Register.size();x++) {
+                    // if RegisterStatus points to the given
+                    // reservation station r set that register[x]
+                    // equal to executed result
+                    if (RegStatus[x].Qi == r) {
+                        // Write back to Registers
+                        Register[x] = ResStation[r].result;
+                        RegStatus[x].Qi = RegStatusEmpty;
+                    }
+                }
+                // Check if any reservation stations are
+                // waiting for current r result
+                PROFILE_COUNT(ProfileBroadcastScan, ResStation.size());
+                for(int y=0;y<(int)ResStation.size();y++){
+                    // check if any reservation stations are
+                    // waiting for the given result as an operand
+                    // Write back to reservation stations
+                    // Given RS is not longer waiting for this
+                    // operand value
+                    if(ResStation[y].Qj==r){
+                        ResStation[y].Vj=ResStation[r].result;
+                        ResStation[y].Qj=OperandAvailable;
+                    }
+                    if(ResStation[y].Qk==r){
+                        ResStation[y].Vk=ResStation[r].result;
+                        ResStation[y].Qk=OperandAvailable;
+                    }
+                }
+                // The given reservation station can
+                // now be used again
+                // Reset RS paramaters
+                ResStation[r].resultReady = false;
+                ResStation[r].busy = false;
+                ResStation[r].Qj = OperandInit;
+                ResStation[r].Qk = OperandInit;
+                ResStation[r].Vj = 0;
+                ResStation[r].Vk = 0;
+                ResStation[r].WRITEBACK_Lat = 0;
+                T.Total_WRITEBACKS++;
+            }
+            else
+                ResStation[r].WRITEBACK_Lat++;
+        }
+    }
+
+}//END WRITEBACK()
+//#######################################################################
@@ -0,0 +1,98 @@
+//
+// Tomasulo machine: architecture, machine state and datapath.
+//
+
+#ifndef TOMASULO_TOMASULO_H
+#define TOMASULO_TOMASULO_H
+
+#include <vector>
+#include "ReservationStation.h"
+#include "Instruction.h"
+#include "RegisterStatus.h"
+#include "HardwareThread.h"
+#include "SharedCDB.h"
+
+// Datapath Latency
+const int ISSUE_Lat = 1;
+const int WRITEBACK_Lat = 1;
+// Temporary fix for errors due to RS names being numbers
+// -> errors with REG/RS/REGSTATUS == zero
+const int ZERO_REG = 5000;
+const int RegStatusEmpty = 1000;
+const int OperandAvailable = 1001;
+const int OperandInit = 1002;
+// Station tags are 0..MaxRS-1, below the sentinels
+const int MaxRS = RegStatusEmpty;
+// SMT issue policies: which thread gets the issue slot
+const int RoundRobinIssue = 0;  // threads take turns
+const int ICountIssue = 1;      // fewest reservation stations in use first
+// Reservation station schedulers
+const int PartitionedRS = 0;    // every class has its own stations
+const int UnifiedRS = 1;        // one pool of stations shared by all classes
+
+class Tomasulo {
+    public:
+        //**** Define Architecture
+        // NUMBER OF RESERVATION STATIONS
+        int Num_ADD_RS;
+        int Num_MULT_RS;
+        int Num_DIV_RS;
+        // RESERVATION STATION LATENCY
+        int ADD_Lat;
+        int MULT_Lat;
+        int DIV_Lat;
+        // RESERVATION STATION SCHEDULER
+        // Unified: Num_RS stations take any op, at most ADD_Cap/MULT_Cap/
+        // DIV_Cap of them per class (0 = no cap). Num_ADD_RS/Num_MULT_RS/
+        // Num_DIV_RS are then the functional units (ports) of each class.
+        int scheduler;
+        int Num_RS;
+        int ADD_Cap;
+        int MULT_Cap;
+        int DIV_Cap;
+        //**** Machine state
+        int Clock;
+        // Hardware threads, each with its own program and register
+        // file, sharing ResStation. One instruction issues per cycle.
+        std::vector<HardwareThread> Thread;
+        std::vector<ReservationStation> ResStation;
+        // Unified scheduler: station executing on each port, -1 if
+        // free, laid out ADD, MULT then DIV
+        std::vector<int> Port;
+        int issuePolicy;
+        // thread that issued last, round-robin starts after it
+        int lastIssued;
+        // thread whose streamed instruction made cycle() fail
+        int faultThread;
+        // Results come from Instruction::result (filled in by a
+        // FunctionalEmulator) instead of being computed in EXECUTE
+        bool resolvedValues;
+        // Keep every instruction in Thread[t].Inst (timing table,
+        // checkpoints). Otherwise written-back instructions are
+        // dropped and only counted, so long runs use bounded memory.
+        bool keepRetired;
+        // CDB shared with other cores, NULL for a private CDB
+        // that takes any number of results per cycle
+        SharedCDB* CDB;
+        // this core's number on CDB, lower numbers win the bus
+        int core;
+    //**** Methods
+    public:
+        Tomasulo();
+        void init(int numRegisters, int numThreads = 1);
+        bool reconfigure(int numAdd, int numMult, int numDiv,
+                         int addLat, int multLat, int divLat);
+        int cycle();
+        bool done();
+        // Datapath
+        int ISSUE();
+        void EXECUTE();
+        void WRITEBACK();
+    private:
+        int fetch(HardwareThread& T);
+        void dropRetired(int t);
+        int issue(int t);
+        bool bindPort(int r);
+};
+
+#endif //TOMASULO_TOMASULO_H
@@ -0,0 +1,64 @@
+//
+// Text trace files, one instruction per line.
+//
+
+#include <cstdio>
+#include <cstring>
+#include "Trace.h"
+
+using namespace std;
+
+static const char* OpNames[] = {"ADD", "SUB", "MULT", "DIV"};
+
+TraceReader::TraceReader(const char* PATH) : path(PATH), in(PATH) {
+    line = 0;
+    error = false;
+}
+bool TraceReader::is_open(){
+    return in.is_open();
+}
+bool TraceReader::next(Instruction& INST){
+    string text;
+    while(getline(in, text)){
+        line++;
+        // strip comments and skip blank lines
+        size_t comment = text.find("//");
+        if(comment != string::npos)
+            text.erase(comment);
+        comment = text.find('#');
+        if(comment != string::npos)
+            text.erase(comment);
+        if(text.find_first_not_of(" \t\r") == string::npos)
+            continue;
+
+        char name[8];
+        int rd, rs, rt;
+        if(sscanf(text.c_str(), " %7s F%d , F%d , F%d", name, &rd, &rs, &rt) != 4){
+            error = true;
+            return false;
+        }
+        for(int op=AddOp; op<=DivOp; op++){
+            if(strcmp(name, OpNames[op]) == 0){
+                INST = Instruction(rd, rs, rt, op);
+                return true;
+            }
+        }
+        error = true;
+        return false;
+    }
+    return false;
+}
+
+long long writeTrace(const char* path, InstructionSource& SOURCE){
+    ofstream out(path);
+    if(!out.is_open())
+        return -1;
+    long long count = 0;
+    Instruction INST;
+    while(SOURCE.next(INST)){
+        out << OpNames[INST.op] << " F" << INST.rd << ",F" << INST.rs <<
+                ",F" << INST.rt << '\n';
+        count++;
+    }
+    return count;
+}
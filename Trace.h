@@ -0,0 +1,31 @@
+//
+// Text trace files, one instruction per line:
+//     ADD F1,F2,F3        // rd <- rs + rt
+//
+
+#ifndef TOMASULO_TRACE_H
+#define TOMASULO_TRACE_H
+
+#include <fstream>
+#include <string>
+#include "InstructionSource.h"
+
+class TraceReader : public InstructionSource {
+    public:
+        std::string path;
+        long long line;     // current line, for error messages
+        bool error;         // set on a malformed line
+    private:
+        std::ifstream in;
+    //**** Methods
+    public:
+        TraceReader(const char*);
+        bool is_open();
+        bool next(Instruction&);
+};
+
+// Drain SOURCE into a trace file. Returns number of instructions
+// written or -1 if the file could not be opened.
+long long writeTrace(const char* path, InstructionSource& SOURCE);
+
+#endif //TOMASULO_TRACE_H
@@ -0,0 +1,74 @@
+//
+// Synthetic instruction stream generator.
+//
+
+#include "WorkloadGenerator.h"
+
+// Longest producer->consumer distance that is tracked
+const int MaxDepDist = 64;
+// Share of source operands that read the constant in F0
+const double ConstOperand = 0.125;
+
+WorkloadGenerator::WorkloadGenerator(){
+    length = 1000;
+    mix[AddOp] = 4;
+    mix[SubOp] = 2;
+    mix[MultOp] = 2;
+    mix[DivOp] = 1;
+    depDist = 4.0;
+    regPool = 13;
+    seed = 1;
+    reset();
+}
+WorkloadGenerator::WorkloadGenerator(long long LENGTH, unsigned SEED){
+    length = LENGTH;
+    mix[AddOp] = 4;
+    mix[SubOp] = 2;
+    mix[MultOp] = 2;
+    mix[DivOp] = 1;
+    depDist = 4.0;
+    regPool = 13;
+    seed = SEED;
+    reset();
+}
+// Restart the stream. Must be called after changing any of
+// the configuration fields.
+void WorkloadGenerator::reset(){
+    generated = 0;
+    rng.seed(seed);
+    recentDest.clear();
+    // opcode drawn from the op mix
+    opDist = std::discrete_distribution<int>(mix, mix+4);
+    // destination never targets F0
+    regDist = std::uniform_int_distribution<int>(1, regPool-1);
+    distDist = std::geometric_distribution<int>(depDist < 1.0 ? 1.0 : 1.0/depDist);
+    constDist = std::bernoulli_distribution(ConstOperand);
+}
+bool WorkloadGenerator::next(Instruction& INST){
+    if(generated >= length)
+        return false;
+    INST = Instruction(regDist(rng), pickOperand(), pickOperand(), opDist(rng));
+
+    // remember destination for later consumers
+    if((int)recentDest.size() < MaxDepDist)
+        recentDest.push_back(INST.rd);
+    else
+        recentDest[generated % MaxDepDist] = INST.rd;
+    generated++;
+    return true;
+}
+// Source operand: now and then the constant in F0 (ZERO_REG),
+// which keeps the other registers from all decaying to 0 (x-x,
+// x/y with y > x and 0*x are 0). Otherwise the destination of the
+// instruction d positions back, d ~ geometric with mean depDist,
+// or a random register if there is no such producer.
+int WorkloadGenerator::pickOperand(){
+    if(constDist(rng))
+        return 0;
+    if(depDist < 1.0 || recentDest.empty())
+        return regDist(rng);
+    long long d = 1 + distDist(rng);
+    if(d > (long long)recentDest.size())
+        return regDist(rng);
+    return recentDest[(generated - d) % MaxDepDist];
+}
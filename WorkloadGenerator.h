@@ -0,0 +1,37 @@
+//
+// Synthetic instruction stream generator.
+//
+
+#ifndef TOMASULO_WORKLOADGENERATOR_H
+#define TOMASULO_WORKLOADGENERATOR_H
+
+#include <random>
+#include <vector>
+#include "InstructionSource.h"
+
+class WorkloadGenerator : public InstructionSource {
+    public:
+        long long length;   // number of instructions to produce
+        int mix[4];         // relative weights of ADD,SUB,MULT,DIV
+        double depDist;     // mean distance to producer of an operand (0 = random operands)
+        int regPool;        // writes F1..F(regPool-1), F0 is only read
+        unsigned seed;
+        long long generated;
+    private:
+        std::mt19937 rng;
+        std::discrete_distribution<int> opDist;
+        std::uniform_int_distribution<int> regDist;
+        std::geometric_distribution<int> distDist;
+        std::bernoulli_distribution constDist;
+        std::vector<int> recentDest; // ring of the last destination registers
+    //**** Methods
+    public:
+        WorkloadGenerator();
+        WorkloadGenerator(long long, unsigned);
+        void reset();
+        bool next(Instruction&);
+    private:
+        int pickOperand();
+};
+
+#endif //TOMASULO_WORKLOADGENERATOR_H
@@ -19,450 +19,686 @@
 #include <iostream>
 #include <iomanip>          // Print Table Formatting
 #include <vector>
-#include "ReservationStation.h"
-#include "Instruction.h"    // MIPS Style Instruction Class
-#include "RegisterStatus.h"
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include "Tomasulo.h"       // Architecture, machine state and datapath
+#include "WorkloadGenerator.h"
+#include "Trace.h"
+#include "Checkpoint.h"
+#include "Sampler.h"
+#include "FunctionalEmulator.h"
+#include "RingBuffer.h"
+#include "BatchTomasulo.h"
+#include "Multicore.h"
+#include "Server.h"
+#include "JobOptions.h"
+#include "Profile.h"
 
 using namespace std;
 
-//#######################################################################
-//**** Define Architecture
-// NUMBER OF RESERVATION STATIONS
-const int Num_ADD_RS = 4;
-const int Num_MULT_RS = 2;
-const int Num_DIV_RS = 3;
-// Opcode Values
-const int AddOp = 0;
-const int SubOp = 1;
-const int MultOp = 2;
-const int DivOp = 3;
-// RESERVATION STATION LATENCY
-const int ADD_Lat = 4;
-const int MULT_Lat = 12;
-const int DIV_Lat = 38;
-// Datapath Latency
-const int ISSUE_Lat = 1;
-const int WRITEBACK_Lat = 1;
-//**** Do not edit these constants
-// Global Clock
-int Clock = 0;
-// used to check if INST == WRITEBACKS to end program
-bool Done = true;
-int Total_WRITEBACKS = 0;
-// Counter for current instruction to issue
-int currentInst_ISSUE = 0;
-// Temporary fix for errors due to RS names being numbers
-// -> errors with REG/RS/REGSTATUS == zero
-const int ZERO_REG = 5000;
-const int RegStatusEmpty = 1000;
-const int OperandAvailable = 1001;
-const int OperandInit = 1002;
-//#######################################################################
+// Instructions buffered between the functional emulator and the timing model
+const int RingCapacity = 4096;
+
+// Consumer end of a ring in main(). However main() returns, the ring
+// is abandoned so a producer waiting on it gives up, and a -pipeline
+// producer thread (it reads main()'s Generator or Trace) is joined.
+class RingConsumer {
+    public:
+        RingBuffer* Ring;
+        thread Producer;
+    //**** Methods
+    public:
+        RingConsumer() : Ring(NULL) {}
+        ~RingConsumer(){
+            if(Ring != NULL)
+                Ring->abandon();
+            if(Producer.joinable())
+                Producer.join();
+        }
+};
 
 //#######################################################################
-// Driver Functions
-int ISSUE(vector<Instruction>& Inst,
-          vector<ReservationStation>& ResStat,
-          vector<RegisterStatus>& RegStat,
-          vector<int>& Register);
-void EXECUTE(vector<Instruction>& Inst,
-             vector<ReservationStation>& ResStat,
-             vector<RegisterStatus>& RegStat,
-             vector<int>& Register);
-void WRITEBACK(vector<Instruction>& Inst,
-               vector<ReservationStation>& ResStat,
-               vector<RegisterStatus>& RegStat,
-               vector<int>& Register);
 // Helper functions
 void printRegisterStatus(vector<RegisterStatus> );
 void printReservationStations(vector<ReservationStation> );
 void printRegisters(vector<int> );
 void printInstructions(vector<Instruction> );
-void printTimingTable(vector<Instruction> );
+void printTimingTable(vector<Instruction>, int );
+void printSummary(long long, int );
+void printThreadSummary(Tomasulo& );
+void printSampledSummary(Sampler& );
+void printBatchResults(vector<BatchTomasulo*>&, int );
+void printMulticoreSummary(Multicore& );
+void printUsage(const char* );
 //#######################################################################
 
 //#######################################################################
 // MAIN DRIVER
-int main(){
-    //**** START Define Architecture
-    // Input program instructions
-    Instruction
-            //(rd,rs,rt,opcode)
-            I0(1,2,3,AddOp),
-            I1(4,1,5,AddOp),
-            I2(6,7,8,SubOp),
-            I3(9,4,10,MultOp),
-            I4(11,12,6,DivOp),
-            I5(8,1,5,MultOp),
-            I6(7,2,3,MultOp);
-    // Pack Instructions into vector
-    vector<Instruction> Inst = {I0,I1,I2,I3,I4,I5,I6};
-
-    //// Input reservation station architecture
-    // DONT FORGET TO UPDATE ^
-    // RESERVATION STATION NUMBERS
-    //const int Num_ADD_RS = 4;
-    //const int Num_MULT_RS = 2;
-    //const int Num_DIV_RS = 3;
-    ReservationStation
-            ADD1(AddOp, OperandInit),
-            ADD2(AddOp, OperandInit),
-            ADD3(AddOp, OperandInit),
-            ADD4(AddOp, OperandInit);
-    ReservationStation
-            MULT1(MultOp, OperandInit),
-            MULT2(MultOp, OperandInit);
-    ReservationStation
-            DIV1(DivOp, OperandInit),
-            DIV2(DivOp, OperandInit),
-            DIV3(DivOp, OperandInit);
-    // Pack reservation stations into vector
-    vector<ReservationStation> ResStation = {ADD1,
-                                             ADD2,
-                                             ADD3,
-                                             ADD4,
-                                             MULT1,
-                                             MULT2,
-                                             DIV1,
-                                             DIV2,
-                                             DIV3};
+int main(int argc, char* argv[]){
+    //**** Command line options
+    Tomasulo CPU;
+    // program and architecture, parsed as in server jobs
+    JobOptions Job;
+    const char* traceOut = NULL;
+    int saveAt = -1;
+    const char* saveFile = NULL;
+    const char* restoreFile = NULL;
+    bool sample = false;
+    Sampler Sampler;
+    bool pipeline = false;
+    const char* produceName = NULL;
+    const char* consumeName = NULL;
+    const char* batchFile = NULL;
+    const char* servePath = NULL;
+    int numThreads = 1;
+    bool threadsGiven = false;
+    int numCores = 0;
+    int quantum = 100;
+    int cdbWidth = 0;
+    bool quiet = false;
+    for(int i=1;i<argc;i++){
+        // every option except -q and -pipeline takes one argument
+        if(strcmp(argv[i],"-q") == 0){
+            quiet = true;
+            continue;
+        }
+        if(strcmp(argv[i],"-pipeline") == 0){
+            pipeline = true;
+            continue;
+        }
+        if(i+1 >= argc){
+            printUsage(argv[0]);
+            return 1;
+        }
+        const char* arg = argv[++i];
+        int taken = Job.parse(argv[i-1], arg);
+        if(taken < 0){
+            printUsage(argv[0]);
+            return 1;
+        }
+        if(taken > 0)
+            continue;
+        if(strcmp(argv[i-1],"-w") == 0)
+            traceOut = arg;
+        else if(strcmp(argv[i-1],"-save") == 0 && i+1 < argc){
+            saveAt = atoi(arg);
+            saveFile = argv[++i];
+        }
+        else if(strcmp(argv[i-1],"-restore") == 0)
+            restoreFile = arg;
+        else if(strcmp(argv[i-1],"-sample") == 0){
+            if(sscanf(arg,"%lld,%d,%d",&Sampler.period,&Sampler.warmup,&Sampler.window) != 3 ||
+               Sampler.window < 1 || Sampler.warmup < 0 ||
+               Sampler.period <= Sampler.warmup+Sampler.window){
+                printUsage(argv[0]);
+                return 1;
+            }
+            sample = true;
+        }
+        else if(strcmp(argv[i-1],"-produce") == 0)
+            produceName = arg;
+        else if(strcmp(argv[i-1],"-consume") == 0)
+            consumeName = arg;
+        else if(strcmp(argv[i-1],"-batch") == 0)
+            batchFile = arg;
+        else if(strcmp(argv[i-1],"-serve") == 0)
+            servePath = arg;
+        else if(strcmp(argv[i-1],"-threads") == 0){
+            numThreads = atoi(arg);
+            if(numThreads < 1){
+                printUsage(argv[0]);
+                return 1;
+            }
+            threadsGiven = true;
+        }
+        else if(strcmp(argv[i-1],"-cores") == 0 || strcmp(argv[i-1],"-quantum") == 0 ||
+                strcmp(argv[i-1],"-cdb") == 0){
+            int value = atoi(arg);
+            if(value < 1 || (strcmp(argv[i-1],"-quantum") == 0 && value > MaxQuantum)){
+                printUsage(argv[0]);
+                return 1;
+            }
+            if(strcmp(argv[i-1],"-cores") == 0)
+                numCores = value;
+            else if(strcmp(argv[i-1],"-quantum") == 0)
+                quantum = value;
+            else
+                cdbWidth = value;
+        }
+        else{
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if(Job.check() != NULL){
+        printUsage(argv[0]);
+        return 1;
+    }
+    Job.Generator.reset();
 
-    // TODO: could make this a vector rather than a class object
-    // Initialize register status objects
-    RegisterStatus
-            F0(RegStatusEmpty),F1(RegStatusEmpty),
-            F2(RegStatusEmpty),F3(RegStatusEmpty),
-            F4(RegStatusEmpty), F5(RegStatusEmpty),
-            F6(RegStatusEmpty),F7(RegStatusEmpty),
-            F8(RegStatusEmpty),F9(RegStatusEmpty),
-            F10(RegStatusEmpty),F11(RegStatusEmpty),
-            F12(RegStatusEmpty);
-    // Pack register status objects into vector
-    vector<RegisterStatus> RegisterStatus =
-            {F0, F1, F2, F3, F4, F5, F6, F7, F8, F9, F10, F11, F12};
+    // Long-running server, the jobs bring their own options
+    if(servePath != NULL){
+        Server Server(servePath, threadsGiven ? numThreads :
+                      max(1, (int)thread::hardware_concurrency()));
+        if(!Server.open()){
+            cerr << "Cannot listen on " << servePath << endl;
+            return 1;
+        }
+        cout << "Listening on " << servePath << " with " << Server.numWorkers <<
+                " workers" << endl;
+        Server.run();
+        return 0;
+    }
 
-    // Initialize register file vector
-    vector<int> Register = {ZERO_REG,1,2,3,4,5,6,7,8,9,10,11,12};
-    //**** END Define Architecture
+    // Write the generated program to a trace file instead of running it
+    if(traceOut != NULL){
+        long long written = writeTrace(traceOut, Job.Generator);
+        if(written < 0){
+            cerr << "Cannot write trace file " << traceOut << endl;
+            return 1;
+        }
+        cout << "Wrote " << written << " instructions to " << traceOut << endl;
+        return 0;
+    }
 
-    cout << "INITIAL VALUES:" << endl;
-    printInstructions(Inst);
-    printReservationStations(ResStation);
-    printRegisters(Register);
-    printRegisterStatus(RegisterStatus);
-    cout << endl;
+    //**** START Define Architecture
+    // Generated and trace programs are streamed into CPU.Thread[t].Inst
+    // one instruction at a time as they issue
+    InstructionSource* Source = NULL;
+    TraceReader* Trace = NULL;
+    if(!Job.traceIn.empty()){
+        Trace = new TraceReader(Job.traceIn.c_str());
+        if(!Trace->is_open()){
+            cerr << "Cannot open trace file " << Job.traceIn << endl;
+            return 1;
+        }
+        Source = Trace;
+    }
+    else if(Job.generate)
+        Source = &Job.Generator;
 
-    //**** START functional loop
-    do{
-        // Datapath
-        Clock++; // system clock
+    // Split the functional model from the timing model: a
+    // FunctionalEmulator resolves the register values and hands the
+    // instructions to the timing model through a ring buffer
+    int numRegisters = Source != NULL ? Job.Generator.regPool : 13;
+    FunctionalEmulator* Emulator = NULL;
+    RingBuffer* Ring = NULL;
+    RingReader* Reader = NULL;
+    RingConsumer Consumer;
+    if(produceName != NULL || pipeline){
+        if(Source == NULL || consumeName != NULL){
+            cerr << "-produce and -pipeline need a generated or trace program" <<
+                    " (-n or -t)" << endl;
+            return 1;
+        }
+        // register file F0 = ZERO_REG, Fi = i
+        vector<int> Register(numRegisters);
+        Register[0] = ZERO_REG;
+        for(int i=1;i<numRegisters;i++)
+            Register[i] = i;
+        Emulator = new FunctionalEmulator(Source, Register);
+    }
+    if(produceName != NULL){
+        Ring = RingBuffer::create(produceName, RingCapacity, numRegisters);
+        if(Ring == NULL){
+            cerr << "Cannot create shared memory ring " << produceName << endl;
+            return 1;
+        }
+        bool drained = produce(Emulator, Ring);
+        Ring->close(Emulator->error || (Trace != NULL && Trace->error));
+        if(Trace != NULL && Trace->error){
+            cerr << Trace->path << ":" << Trace->line <<
+                    ": malformed instruction" << endl;
+            return 1;
+        }
+        if(Emulator->error){
+            cerr << "Instruction " << Emulator->executed <<
+                    " uses a register outside F0-F" << numRegisters-1 <<
+                    " (see -regs)" << endl;
+            return 1;
+        }
+        cout << "Produced " << Emulator->executed << " instructions into " <<
+                produceName << (drained ? "" : " (the consumer stopped early)") << endl;
+        return 0;
+    }
+    if(pipeline){
+        Ring = new RingBuffer(RingCapacity, numRegisters);
+        Consumer.Ring = Ring;
+        Consumer.Producer = thread([Emulator, Trace, Ring](){
+            produce(Emulator, Ring);
+            Ring->close(Emulator->error || (Trace != NULL && Trace->error));
+        });
+        Reader = new RingReader(Ring);
+        Source = Reader;
+    }
+    else if(consumeName != NULL){
+        if(Source != NULL){
+            cerr << "-consume reads its program from the ring, not -n or -t" << endl;
+            return 1;
+        }
+        // wait up to a minute for the producer to create the ring
+        for(int tries=0;Ring == NULL && tries < 6000;tries++){
+            Ring = RingBuffer::open(consumeName);
+            if(Ring == NULL)
+                this_thread::sleep_for(chrono::milliseconds(10));
+        }
+        if(Ring == NULL){
+            cerr << "Cannot open shared memory ring " << consumeName << endl;
+            return 1;
+        }
+        // both sides are attached, the name is no longer needed
+        Ring->unlink();
+        Consumer.Ring = Ring;
+        numRegisters = Ring->numRegisters();
+        Reader = new RingReader(Ring);
+        Source = Reader;
+    }
 
-        ISSUE(Inst,ResStation,RegisterStatus,Register);
-		EXECUTE(Inst,ResStation,RegisterStatus,Register);
-		WRITEBACK(Inst,ResStation,RegisterStatus,Register);
+    // Every other hardware thread (and core) streams its own copy of
+    // the program: the trace is reopened, generated programs continue
+    // with seed+1, seed+2, ...
+    vector<TraceReader*> Traces;
+    if(Trace != NULL)
+        Traces.push_back(Trace);
+    auto copySource = [&](int k) -> InstructionSource* {
+        if(!Job.traceIn.empty()){
+            Traces.push_back(new TraceReader(Job.traceIn.c_str()));
+            return Traces.back();
+        }
+        WorkloadGenerator* Copy = new WorkloadGenerator(Job.Generator);
+        Copy->seed = Job.Generator.seed + k;
+        Copy->reset();
+        return Copy;
+    };
 
-        // PRINT
-        printRegisters(Register);
-        printTimingTable(Inst);
-        cout << endl;
+    if(restoreFile != NULL){
+        if(Job.unifiedRS > 0){
+            cerr << "-unified and -cap are taken from the checkpoint" << endl;
+            return 1;
+        }
+        if(!loadCheckpoint(restoreFile, CPU)){
+            cerr << "Cannot restore checkpoint " << restoreFile << endl;
+            return 1;
+        }
+        if(Job.smtGiven && (int)CPU.Thread.size() != Job.numSMT){
+            cerr << "-smt does not match the " << CPU.Thread.size() <<
+                    " threads of the checkpoint" << endl;
+            return 1;
+        }
+        Job.numSMT = CPU.Thread.size();
+        // Fork into a different architecture
+        if(Job.rsGiven || Job.latGiven){
+            if(!Job.rsGiven){
+                Job.numRS[0] = CPU.Num_ADD_RS;
+                Job.numRS[1] = CPU.Num_MULT_RS;
+                Job.numRS[2] = CPU.Num_DIV_RS;
+            }
+            if(!Job.latGiven){
+                Job.lat[0] = CPU.ADD_Lat;
+                Job.lat[1] = CPU.MULT_Lat;
+                Job.lat[2] = CPU.DIV_Lat;
+            }
+            if(!CPU.reconfigure(Job.numRS[0],Job.numRS[1],Job.numRS[2],
+                                Job.lat[0],Job.lat[1],Job.lat[2])){
+                cerr << "-rs would remove a busy " << (CPU.scheduler == UnifiedRS ?
+                        "functional unit" : "reservation station") << endl;
+                return 1;
+            }
+        }
+    }
+    else{
+        // NUMBER OF RESERVATION STATIONS / LATENCY
+        if(Job.rsGiven){
+            CPU.Num_ADD_RS = Job.numRS[0];
+            CPU.Num_MULT_RS = Job.numRS[1];
+            CPU.Num_DIV_RS = Job.numRS[2];
+        }
+        if(Job.latGiven){
+            CPU.ADD_Lat = Job.lat[0];
+            CPU.MULT_Lat = Job.lat[1];
+            CPU.DIV_Lat = Job.lat[2];
+        }
+        // One pool of stations for every op class
+        if(Job.unifiedRS > 0){
+            CPU.scheduler = UnifiedRS;
+            CPU.Num_RS = Job.unifiedRS;
+            CPU.ADD_Cap = Job.cap[0];
+            CPU.MULT_Cap = Job.cap[1];
+            CPU.DIV_Cap = Job.cap[2];
+        }
+        // Reservation stations and, per hardware thread, register
+        // status and register file F0 = ZERO_REG, Fi = i
+        CPU.init(numRegisters, Job.numSMT);
 
-        // Check if all reservation stations are empty -> program done
-        // TODO: if LW/SW are added this will need to be udated
-        Done = false;
-        if(Total_WRITEBACKS == Inst.size())
-            Done = true;
-        cout << endl;
-	}while(!Done);//**** End functional loop
+        if(Source == NULL){
+            // Input program instructions
+            Instruction
+                    //(rd,rs,rt,opcode)
+                    I0(1,2,3,AddOp),
+                    I1(4,1,5,AddOp),
+                    I2(6,7,8,SubOp),
+                    I3(9,4,10,MultOp),
+                    I4(11,12,6,DivOp),
+                    I5(8,1,5,MultOp),
+                    I6(7,2,3,MultOp);
+            // Pack Instructions into vector (every thread runs a copy)
+            for(int t=0;t<Job.numSMT;t++)
+                CPU.Thread[t].Inst = {I0,I1,I2,I3,I4,I5,I6};
+        }
+    }
+    if(Job.numSMT > 1 && (Ring != NULL || sample || batchFile != NULL)){
+        cerr << "-smt cannot be combined with -sample, -batch or" <<
+                " the functional/timing split" << endl;
+        return 1;
+    }
+    for(int t=0;t<Job.numSMT && Source != NULL;t++){
+        HardwareThread& T = CPU.Thread[t];
+        T.Source = t == 0 ? Source : copySource(t);
+        // Skip the part of the stream already in the checkpoint
+        if(restoreFile != NULL){
+            Instruction skipped;
+            for(int i=0;i<(int)T.Inst.size();i++){
+                if(!T.Source->next(skipped)){
+                    cerr << "Program is shorter than the checkpoint" << endl;
+                    return 1;
+                }
+                // the options must regenerate the saved run's program
+                const Instruction& saved = T.Inst[i];
+                if(skipped.rd != saved.rd || skipped.rs != saved.rs ||
+                   skipped.rt != saved.rt || skipped.op != saved.op){
+                    cerr << "Program does not match the checkpoint (instruction " <<
+                            i << ")" << endl;
+                    return 1;
+                }
+            }
+        }
+    }
+    if(Job.issueGiven || restoreFile == NULL)
+        CPU.issuePolicy = Job.issuePolicy;
+    CPU.resolvedValues = Ring != NULL;
+    // -q prints no timing table, only a checkpoint needs the program
+    CPU.keepRetired = !quiet || saveFile != NULL;
+    //**** END Define Architecture
 
-    return 0;
-}//**** END MAIN DRIVER
-//#######################################################################
+    // Sampled simulation of a streamed program
+    if(sample){
+        if(Source == NULL || restoreFile != NULL || saveFile != NULL){
+            cerr << "-sample needs a generated or trace program (-n or -t)" <<
+                    " and no checkpoint" << endl;
+            return 1;
+        }
+        if(Sampler.run(*Source, CPU) < 0){
+            cerr << "Instruction " << Sampler.instructions <<
+                    " uses a register outside F0-F" << numRegisters-1 <<
+                    " (see -regs)" << endl;
+            return 1;
+        }
+        if(Trace != NULL && Trace->error){
+            cerr << Trace->path << ":" << Trace->line <<
+                    ": malformed instruction" << endl;
+            return 1;
+        }
+        if(Reader != NULL && Reader->error){
+            cerr << "The producer failed or sent an unknown operation," <<
+                    " the instruction stream is incomplete" << endl;
+            return 1;
+        }
+        // nothing to extrapolate from
+        if(Sampler.samples == 0){
+            cerr << "No sample taken: the program has " << Sampler.instructions <<
+                    " instructions, the first sample needs " << Sampler.period+1 <<
+                    " (see -sample)" << endl;
+            return 1;
+        }
+        printRegisters(CPU.Thread[0].Register);
+        printSampledSummary(Sampler);
+        delete Trace;
+        return 0;
+    }
 
-//#######################################################################
-// Datapath FUNCTIONS
-int ISSUE(vector<Instruction>& INST,
-          vector<ReservationStation>& RESSTATION,
-          vector<RegisterStatus>& REGSTATUS,
-          vector<int>& REG){
-    // Latency of 1 if issued
-    //**** check if spot in given reservation station is available
-    int r = 0;
-    bool rsFree = false;
-    // r is the current instruction to be issued's operation
-    // code(add,sub,mult,div)
-    // If all instructions have been issued then stop issueing
-    // for rest of program
-    if(currentInst_ISSUE >= INST.size())
-            return 0;
-    r = INST[currentInst_ISSUE].op;
-    // determine if there is an open RS of r type. if yes
-    // -> r = that open spot.
-    // Boundry's of given RS
-    int RSAddStart = Num_ADD_RS-Num_ADD_RS;
-    int RSAddEnd = Num_ADD_RS;
-    int RSSubStart = Num_ADD_RS-Num_ADD_RS;
-    int RSSubEnd = Num_ADD_RS;
-    int RSMulStart = Num_ADD_RS;
-    int RSMulEnd = Num_ADD_RS+Num_MULT_RS;
-    int RSDivStart = Num_ADD_RS+Num_MULT_RS;
-    int RSDivEnd = Num_ADD_RS+Num_MULT_RS+Num_DIV_RS;
-    switch(r){
-        case AddOp:
-            for(int i=RSAddStart;i<RSAddEnd;i++){
-                if(!RESSTATION[i].busy){
-                    r = i;
-                    currentInst_ISSUE++;
-                    RESSTATION[i].op = AddOp;
-                    rsFree = true;
-                    break;
+    // Many architectures of the same program at once
+    if(batchFile != NULL){
+        if(restoreFile != NULL || saveFile != NULL || sample || Job.unifiedRS > 0){
+            cerr << "-batch cannot be combined with checkpoints, -sample or -unified" << endl;
+            return 1;
+        }
+        vector<BatchConfig> Config;
+        int bad = readBatchConfigs(batchFile, Config);
+        if(bad != 0 || Config.empty()){
+            if(bad < 0)
+                cerr << "Cannot open " << batchFile << endl;
+            else
+                cerr << batchFile << ":" << bad << ": expected A,M,D A,M,D" << endl;
+            return 1;
+        }
+        int maxRS[3] = {0, 0, 0};
+        for(int k=0;k<(int)Config.size();k++)
+            for(int c=0;c<3;c++)
+                if(Config[k].numRS[c] > maxRS[c])
+                    maxRS[c] = Config[k].numRS[c];
+        if(maxRS[0]+maxRS[1]+maxRS[2] > BatchMaxStations){
+            cerr << "-batch supports at most " << BatchMaxStations <<
+                    " stations (largest ADD + MULT + DIV count)" << endl;
+            return 1;
+        }
+        // every lane runs the whole program, read it in once
+        vector<Instruction> Program = CPU.Thread[0].Inst;
+        if(Source != NULL){
+            Instruction INST;
+            while(Source->next(INST)){
+                if(INST.rd < 0 || INST.rd >= numRegisters ||
+                   INST.rs < 0 || INST.rs >= numRegisters ||
+                   INST.rt < 0 || INST.rt >= numRegisters){
+                    cerr << "Instruction " << Program.size() <<
+                            " uses a register outside F0-F" << numRegisters-1 <<
+                            " (see -regs)" << endl;
+                    return 1;
                 }
+                Program.push_back(INST);
             }
-            // if instruction is not issued because no
-            // reservation stations are free exit ISSUE
-            // Init is not necessary if instruction not issued
-            if(!rsFree)
+            if(Trace != NULL && Trace->error){
+                cerr << Trace->path << ":" << Trace->line <<
+                        ": malformed instruction" << endl;
                 return 1;
-            break;
-        case SubOp:
-            for(int i=RSSubStart;i<RSSubEnd;i++){
-                if(!RESSTATION[i].busy){
-                    r = i;
-                    currentInst_ISSUE++;
-                    RESSTATION[i].op = SubOp;
-                    rsFree = true;
-                    break;
-                }
             }
-            if(!rsFree)
+            if(Emulator != NULL && Emulator->error){
+                cerr << "Instruction " << Emulator->executed <<
+                        " uses a register outside F0-F" << numRegisters-1 <<
+                        " (see -regs)" << endl;
                 return 1;
-            break;
-        case MultOp:
-            for(int i=RSMulStart;i<RSMulEnd;i++){
-                if(!RESSTATION[i].busy){
-                    r = i;
-                    currentInst_ISSUE++;
-                    RESSTATION[i].op = MultOp;
-                    rsFree = true;
-                    break;
-                }
             }
-            if(!rsFree)
+            if(Reader != NULL && Reader->error){
+                cerr << "The producer failed or sent an unknown operation," <<
+                        " the instruction stream is incomplete" << endl;
                 return 1;
-            break;
-        case DivOp:
-            for(int i=RSDivStart;i<RSDivEnd;i++){
-                if(!RESSTATION[i].busy){
-                    r = i;
-                    currentInst_ISSUE++;
-                    RESSTATION[i].op = DivOp;
-                    rsFree = true;
-                    break;
-                }
             }
-            if(!rsFree)
-                return 1;
-            break;
-        default:
-            break;
-    }
-    //**** Initialize characteristics of issued instruction
-    // if operand rs is available -> set value of operand
-    // (Vj) to given register value
-    // else point operand to the reservation station (Qj)
-    // that will give the operand value
-    // NOTE: since currentInst was in incremented we must
-    // do currentINST_ISSUE-1
-    if(REGSTATUS[INST[currentInst_ISSUE-1].rs].Qi == RegStatusEmpty){
-        RESSTATION[r].Vj = REG[INST[currentInst_ISSUE-1].rs];
-        RESSTATION[r].Qj = OperandAvailable;
-    }
-    else{
-        RESSTATION[r].Qj = REGSTATUS[INST[currentInst_ISSUE-1].rs].Qi;
+        }
+        // split the lanes over the host threads
+        if(numThreads > (int)Config.size())
+            numThreads = Config.size();
+        vector<BatchTomasulo*> Batch;
+        vector<thread> Workers;
+        for(int t=0;t<numThreads;t++){
+            vector<BatchConfig> Part(Config.begin() + Config.size()*t/numThreads,
+                                     Config.begin() + Config.size()*(t+1)/numThreads);
+            Batch.push_back(new BatchTomasulo(Part, Program, numRegisters));
+        }
+        for(int t=0;t<numThreads;t++){
+            BatchTomasulo* B = Batch[t];
+            Workers.push_back(thread([B](){
+                while(!B->done())
+                    B->cycle();
+            }));
+        }
+        for(int t=0;t<numThreads;t++)
+            Workers[t].join();
+        printBatchResults(Batch, Program.size());
+        for(int t=0;t<numThreads;t++)
+            delete Batch[t];
+        return 0;
     }
-    // if operand rt is available -> set value of
-    // operand (Vk) to given register value
-    // else point operand to the reservation station
-    // (Qk) that will give the operand value
-    if(REGSTATUS[INST[currentInst_ISSUE-1].rt].Qi == RegStatusEmpty){
-        RESSTATION[r].Vk = REG[INST[currentInst_ISSUE-1].rt];
-        RESSTATION[r].Qk = OperandAvailable;
+
+    // Several cores, each with its own copy of the program
+    // (generated programs use seed, seed+1, ... for every
+    // hardware thread of every core)
+    if(numCores > 0){
+        if(restoreFile != NULL || saveFile != NULL || sample || Ring != NULL){
+            cerr << "-cores cannot be combined with checkpoints, -sample or" <<
+                    " the functional/timing split" << endl;
+            return 1;
+        }
+        SharedCDB* CDB = cdbWidth > 0 ? new SharedCDB(cdbWidth, quantum, numCores) : NULL;
+        vector<Tomasulo*> Core;
+        for(int c=0;c<numCores;c++){
+            // core 0 runs the streams already attached to CPU
+            Tomasulo* Core_c = new Tomasulo(CPU);
+            for(int t=0;t<Job.numSMT && c > 0 && Source != NULL;t++)
+                Core_c->Thread[t].Source = copySource(c*Job.numSMT+t);
+            Core.push_back(Core_c);
+        }
+        Multicore Machine(Core, quantum, CDB);
+        Machine.run(threadsGiven ? numThreads : numCores);
+        for(int k=0;k<(int)Traces.size();k++){
+            if(Traces[k]->error){
+                cerr << Traces[k]->path << ":" << Traces[k]->line <<
+                        ": malformed instruction" << endl;
+                return 1;
+            }
+        }
+        for(int c=0;c<numCores;c++){
+            if(Machine.status[c] == -2){
+                cerr << "Core " << c << ": the run needs more than " << INT_MAX <<
+                        " cycles" << endl;
+                return 1;
+            }
+            if(Machine.status[c] < 0){
+                cerr << "Core " << c << ": instruction " <<
+                        Core[c]->Thread[Core[c]->faultThread].numInstructions() <<
+                        " uses a register outside F0-F" << numRegisters-1 <<
+                        " (see -regs)" << endl;
+                return 1;
+            }
+        }
+        printMulticoreSummary(Machine);
+        return 0;
     }
-    else{
-        RESSTATION[r].Qk = REGSTATUS[INST[currentInst_ISSUE-1].rt].Qi;
+
+    if(!quiet){
+        cout << "INITIAL VALUES:" << endl;
+        for(int t=0;t<Job.numSMT;t++){
+            if(Job.numSMT > 1)
+                cout << "Thread " << t << ":" << endl;
+            printInstructions(CPU.Thread[t].Inst);
+        }
+        printReservationStations(CPU.ResStation);
+        for(int t=0;t<Job.numSMT;t++){
+            if(Job.numSMT > 1)
+                cout << "Thread " << t << ":" << endl;
+            printRegisters(CPU.Thread[t].Register);
+            printRegisterStatus(CPU.Thread[t].RegStatus);
+        }
+        cout << endl;
     }
-    // given reservation station is now busy
-    // until write back stage is completed.
-    RESSTATION[r].busy = true;
-    RESSTATION[r].ISSUE_Lat = 0;
-    // set reservation station instuction
-    // number == current instruction
-    RESSTATION[r].instNum = currentInst_ISSUE-1;
-    // set clock cycle for issue time
-    INST[currentInst_ISSUE-1].issueClock = Clock;
-    // The register status Qi is set to the current
-    // instructions reservation station location r
-    REGSTATUS[INST[currentInst_ISSUE-1].rd].Qi = r;
-    return 2;
-}//END ISSUE()
-void EXECUTE(vector<Instruction>& INST,
-             vector<ReservationStation>& RESSTATION,
-             vector<RegisterStatus>& REGSTATUS,
-             vector<int>& REG){
-    // check each reservation station to see
-    // if both operands are ready
-    // The current reservation station is r
-    for (int r=0;r<RESSTATION.size();r++){
-        // if both operands are available then
-        // execute given instructions operation
-        // and set resultReady flag to true so that
-        // result can be written back to CDB
-        // first check if instruction has been issued
-        if(RESSTATION[r].busy == true){
-            // second check if the ISSUE latency clock cycle has happened
-            if(RESSTATION[r].ISSUE_Lat >= ISSUE_Lat){
-                // third check if both operands are available
-                if(RESSTATION[r].Qj == OperandAvailable &&
-                        RESSTATION[r].Qk == OperandAvailable){
-                    // Set clock cycle when execution begins
-                    if(INST[RESSTATION[r].instNum].executeClockBegin == 0)
-                        INST[RESSTATION[r].instNum].executeClockBegin = Clock;
-                    // when execution starts we must wait the given
-                    // latency number of clock cycles before making result
-                    // available to WriteBack
-                    // Delay: Switch(INST.op)
-                    //		case(add): 	clock += 4;
-                    //		case(mult): 	clock += 12;
-                    //		case(div):	clock += 38;
-                    RESSTATION[r].lat++;
-                    switch(RESSTATION[r].op){
-                        case(AddOp):
-                            if(RESSTATION[r].lat == ADD_Lat){
-                                RESSTATION[r].result = RESSTATION[r].Vj + RESSTATION[r].Vk;
-                                // Result is ready to be writenback
-                                RESSTATION[r].resultReady = true;
-                                RESSTATION[r].lat = 0;
-                                // Set clock cycle when execution ends
-                                INST[RESSTATION[r].instNum].executeClockEnd = Clock;
-                                // reset ISSUE latency for RS
-                                RESSTATION[r].ISSUE_Lat = 0;
-                            }
-                        case(SubOp):
-                            if(RESSTATION[r].lat == ADD_Lat){
-                                RESSTATION[r].result = RESSTATION[r].Vj - RESSTATION[r].Vk;
-                                RESSTATION[r].resultReady = true;
-                                RESSTATION[r].lat = 0;
-                                // Set clock cycle when execution ends
-                                INST[RESSTATION[r].instNum].executeClockEnd = Clock;
-                                // reset ISSUE latency for RS
-                                RESSTATION[r].ISSUE_Lat = 0;
-                            }
-                        case(MultOp):
-                            if(RESSTATION[r].lat == MULT_Lat){
-                                RESSTATION[r].result = RESSTATION[r].Vj * RESSTATION[r].Vk;
-                                RESSTATION[r].resultReady = true;
-                                RESSTATION[r].lat = 0;
-                                // Set clock cycle when execution ends
-                                INST[RESSTATION[r].instNum].executeClockEnd = Clock;
-                                // reset ISSUE latency for RS
-                                RESSTATION[r].ISSUE_Lat = 0;
-                            }
-                        case(DivOp):
-                            if(RESSTATION[r].lat == DIV_Lat){
-                                RESSTATION[r].result = RESSTATION[r].Vj / RESSTATION[r].Vk;
-                                RESSTATION[r].resultReady = true;
-                                RESSTATION[r].lat = 0;
-                                // Set clock cycle when execution ends
-                                INST[RESSTATION[r].instNum].executeClockEnd = Clock;
-                                // reset ISSUE latency for RS
-                                RESSTATION[r].ISSUE_Lat = 0;
-                            }
-                        default:
-                            break;
-                    }
-                }
+
+    //**** START functional loop
+    bool Done = true;
+    do{
+        // Datapath
+        int status = CPU.cycle();
+        if(status == -2){
+            cerr << "The run needs more than " << INT_MAX << " cycles" << endl;
+            return 1;
+        }
+        if(status < 0){
+            if(Job.numSMT > 1)
+                cerr << "Thread " << CPU.faultThread << ": ";
+            cerr << "Instruction " << CPU.Thread[CPU.faultThread].numInstructions() <<
+                    " uses a register outside F0-F" << numRegisters-1 <<
+                    " (see -regs)" << endl;
+            return 1;
+        }
+        // Traces[k] feeds thread k (a pipelined producer
+        // is done with Trace once the stream ends)
+        for(int k=0;k<(int)Traces.size();k++){
+            if(CPU.Thread[k].Source == NULL && Traces[k]->error){
+                cerr << Traces[k]->path << ":" << Traces[k]->line <<
+                        ": malformed instruction" << endl;
+                return 1;
             }
-            else // Execute is not ready until one cycle latency of ISSUE
-                RESSTATION[r].ISSUE_Lat++;
+        }
+        if(CPU.Thread[0].Source == NULL && Emulator != NULL && Emulator->error){
+            cerr << "Instruction " << Emulator->executed <<
+                    " uses a register outside F0-F" << numRegisters-1 <<
+                    " (see -regs)" << endl;
+            return 1;
+        }
+        if(CPU.Thread[0].Source == NULL && Reader != NULL && Reader->error){
+            cerr << "The producer failed or sent an unknown operation," <<
+                    " the instruction stream is incomplete" << endl;
+            return 1;
         }
 
-    }
+        // PRINT
+        if(!quiet){
+            for(int t=0;t<Job.numSMT;t++){
+                if(Job.numSMT > 1)
+                    cout << "Thread " << t << ":" << endl;
+                printRegisters(CPU.Thread[t].Register);
+                printTimingTable(CPU.Thread[t].Inst, CPU.Clock);
+            }
+            cout << endl;
+        }
 
-}//END EXECUTE()
-void WRITEBACK(vector<Instruction>& INST,
-               vector<ReservationStation>& RESSTATION,
-               vector<RegisterStatus>& REGSTATUS,
-               vector<int>& REG){
-    // Check each reservation station to see
-    // if operational delay is done -> result is ready
-    for(int r=0;r<RESSTATION.size();r++){
-        // if result ready write back to CDB
-        // -> Register,and reservation stations
-        if(RESSTATION[r].resultReady){
-            // Before Writeback is available there
-            // must be a 1 cycle WB delay
-            if(RESSTATION[r].WRITEBACK_Lat == WRITEBACK_Lat){
-                // set clock cycle when write back occured.
-                // (Must add one because increment happens after loop)
-                if(INST[RESSTATION[r].instNum].writebackClock == 0)
-                    INST[RESSTATION[r].instNum].writebackClock = Clock;
-                // Check if any registers (via the registerStatus)
-                // are waiting for current r result
-                for(int x=0;x<REG.size();x++) {
-                    // if RegisterStatus points to the given
-                    // reservation station r set that register[x]
-                    // equal to executed result
-                    if (REGSTATUS[x].Qi == r) {
-                        // Write back to Registers
-                        REG[x] = RESSTATION[r].result;
-                        REGSTATUS[x].Qi = RegStatusEmpty;
-                    }
-                }
-                // Check if any reservation stations are
-                // waiting for current r result
-                for(int y=0;y<RESSTATION.size();y++){
-                    // check if any reservation stations are
-                    // waiting for the given result as an operand
-                    // Write back to reservation stations
-                    // Given RS is not longer waiting for this
-                    // operand value
-                    if(RESSTATION[y].Qj==r){
-                        RESSTATION[y].Vj=RESSTATION[r].result;
-                        RESSTATION[y].Qj=OperandAvailable;
-                    }
-                    if(RESSTATION[y].Qk==r){
-                        RESSTATION[y].Vk=RESSTATION[r].result;
-                        RESSTATION[y].Qk=OperandAvailable;
-                    }
-                }
-                // The given reservation station can
-                // now be used again
-                // Reset RS paramaters
-                RESSTATION[r].resultReady = false;
-                RESSTATION[r].busy = false;
-                RESSTATION[r].Qj = OperandInit;
-                RESSTATION[r].Qk = OperandInit;
-                RESSTATION[r].Vj = 0;
-                RESSTATION[r].Vk = 0;
-                RESSTATION[r].WRITEBACK_Lat = 0;
-                Total_WRITEBACKS++;
+        // Check if all reservation stations are empty -> program done
+        Done = CPU.done();
+        if(!quiet)
+            cout << endl;
+
+        if(CPU.Clock == saveAt){
+            if(!saveCheckpoint(saveFile, CPU)){
+                cerr << "Cannot write checkpoint " << saveFile << endl;
+                return 1;
             }
-            else
-                RESSTATION[r].WRITEBACK_Lat++;
+            cout << "Checkpoint at cycle " << CPU.Clock << " written to " <<
+                    saveFile << endl;
+            return 0;
         }
-    }
+	}while(!Done);//**** End functional loop
 
-}//END WRITEBACK()
+    if(saveFile != NULL){
+        cerr << "Program finished at cycle " << CPU.Clock << ", checkpoint cycle " <<
+                saveAt << " was never reached" << endl;
+        return 1;
+    }
+    if(quiet){
+        if(Job.numSMT > 1)
+            printThreadSummary(CPU);
+        else{
+            printRegisters(CPU.Thread[0].Register);
+            printSummary(CPU.Thread[0].numInstructions(), CPU.Clock);
+        }
+    }
+    delete Trace;
+    return 0;
+}//**** END MAIN DRIVER
 //#######################################################################
 
 //#######################################################################
 // Helper Functions
 void printRegisterStatus(vector<RegisterStatus> RegisterStatusVector){
+    PROFILE_SCOPE(ProfilePrint);
     cout << "Register Status: " << endl;
     for(int i=0; i<RegisterStatusVector.size(); i++)
         cout << RegisterStatusVector[i].Qi << ' ';
     cout << endl;
 }
 void printReservationStations(vector<ReservationStation> RSV){
+    PROFILE_SCOPE(ProfilePrint);
     for(int i=0; i<RSV.size(); i++)
         cout << "RS #: " << i << "  Busy: " << RSV[i].busy << "  op: "<<
                 RSV[i].op << "  Vj: " << RSV[i].Vj << "  Vk: " <<
@@ -470,19 +706,22 @@ void printReservationStations(vector<ReservationStation> RSV){
                 RSV[i].Qk << endl;
 }
 void printRegisters(vector<int> RegistersVector){
+    PROFILE_SCOPE(ProfilePrint);
     cout << "Register Content:" << endl;
     for(int i=0; i<RegistersVector.size(); i++)
         cout << RegistersVector[i] << ' ';
     cout << endl;
 }
 void printInstructions(vector<Instruction> IV){
+    PROFILE_SCOPE(ProfilePrint);
     for(int i=0; i<IV.size(); i++)
         cout << "Instruction #: " << i << "  Operation: " <<
                 IV[i].op << "  " <<
                 IV[i].rd << " <- " << IV[i].rs << " op " <<
                 IV[i].rt << endl;
 }
-void printTimingTable(vector<Instruction> INST){
+void printTimingTable(vector<Instruction> INST, int Clock){
+    PROFILE_SCOPE(ProfilePrint);
     char separator    = ' ';
     const int width     = 10;
     char lineSeperator = '-';
@@ -510,4 +749,142 @@ void printTimingTable(vector<Instruction> INST){
     }
 
 }
+void printSummary(long long numInst, int Clock){
+    PROFILE_SCOPE(ProfilePrint);
+    cout << "Instructions: " << numInst << "  Cycles: " << Clock <<
+            "  IPC: " << fixed << setprecision(3) <<
+            (Clock > 0 ? (double)numInst/Clock : 0.0) << endl;
+}
+// Per hardware thread registers and progress, then the whole core
+void printThreadSummary(Tomasulo& CPU){
+    long long instructions = 0;
+    for(int t=0;t<(int)CPU.Thread.size();t++){
+        cout << "Thread " << t << "  ";
+        printRegisters(CPU.Thread[t].Register);
+        instructions += CPU.Thread[t].numInstructions();
+    }
+    for(int t=0;t<(int)CPU.Thread.size();t++){
+        cout << "Thread " << t << "  ";
+        printSummary(CPU.Thread[t].numInstructions(), CPU.Thread[t].lastWriteback());
+    }
+    cout << "Total  ";
+    printSummary(instructions, CPU.Clock);
+    cout << "Issue policy: " <<
+            (CPU.issuePolicy == ICountIssue ? "ICOUNT" : "round-robin") << endl;
+}
+void printSampledSummary(Sampler& S){
+    PROFILE_SCOPE(ProfilePrint);
+    cout << "Instructions: " << S.instructions << "  Samples: " << S.samples <<
+            "  Detailed: " << S.detailed << endl;
+    if(S.samples < 2){
+        // one sample has no spread to give a confidence interval
+        cout << fixed << setprecision(3) << "CPI: " << S.cpiMean <<
+                setprecision(0) << "  Estimated cycles: " << S.estimatedCycles() <<
+                " (single sample, no confidence interval)" << endl;
+        return;
+    }
+    cout << fixed << setprecision(3) << "CPI: " << S.cpiMean << " +/- " <<
+            1.96*S.cpiStdDev/sqrt((double)S.samples) <<
+            setprecision(0) << "  Estimated cycles: " << S.estimatedCycles() <<
+            " +/- " << S.confidence95() << " (95% confidence)" << endl;
+}
+void printBatchResults(vector<BatchTomasulo*>& Batch, int numInst){
+    PROFILE_SCOPE(ProfilePrint);
+    char separator    = ' ';
+    const int width     = 10;
+
+    cout << left << setw(width) << setfill(separator) << "Config";
+    cout << left << setw(width) << setfill(separator) << "Stations";
+    cout << left << setw(width) << setfill(separator) << "Latency";
+    cout << left << setw(width) << setfill(separator) << "Cycles";
+    cout << left << setw(width) << setfill(separator) << "IPC" << endl;
+    int n = 0;
+    for(int t=0;t<(int)Batch.size();t++){
+        for(int k=0;k<Batch[t]->lanes;k++){
+            const BatchConfig& C = Batch[t]->Config[k];
+            int cycles = Batch[t]->doneClock[k];
+            cout << left << setw(width) << setfill(separator) << n++;
+            cout << left << setw(width) << setfill(separator) <<
+                    to_string(C.numRS[0]) + "," + to_string(C.numRS[1]) + "," +
+                    to_string(C.numRS[2]);
+            cout << left << setw(width) << setfill(separator) <<
+                    to_string(C.lat[0]) + "," + to_string(C.lat[1]) + "," +
+                    to_string(C.lat[2]);
+            cout << left << setw(width) << setfill(separator) << cycles;
+            cout << fixed << setprecision(3) << (double)numInst/cycles << endl;
+        }
+    }
+}
+void printMulticoreSummary(Multicore& M){
+    int cycles = 0;
+    long long instructions = 0;
+    for(int c=0;c<(int)M.Core.size();c++){
+        long long coreInstructions = 0;
+        for(int t=0;t<(int)M.Core[c]->Thread.size();t++)
+            coreInstructions += M.Core[c]->Thread[t].numInstructions();
+        cout << "Core " << c << "  ";
+        printSummary(coreInstructions, M.Core[c]->Clock);
+        if(M.Core[c]->Clock > cycles)
+            cycles = M.Core[c]->Clock;
+        instructions += coreInstructions;
+    }
+    cout << "Total  Instructions: " << instructions << "  Cycles: " << cycles <<
+            "  IPC: " << fixed << setprecision(3) <<
+            (cycles > 0 ? (double)instructions/cycles : 0.0) << endl;
+    if(M.CDB != NULL)
+        cout << "Shared CDB: " << M.CDB->width << " results/cycle, " <<
+                M.CDB->conflicts << " results delayed" << endl;
+}
+void printUsage(const char* name){
+    cerr << "Usage: " << name << " [options]" << endl <<
+            "  (no options runs the built-in example program)" << endl <<
+            "Workload:" << endl <<
+            "  -n N          generate N instructions" << endl <<
+            "  -mix A,S,M,D  relative ADD,SUB,MULT,DIV weights (default 4,2,2,1)" << endl <<
+            "  -dep D        mean dependency distance, 0 = random operands (default 4)" << endl <<
+            "  -regs R       register file size F0..F(R-1) (default 13, at most 4096)" << endl <<
+            "  -seed S       generator seed (default 1)" << endl <<
+            "  -t FILE       run a trace file instead" << endl <<
+            "  -w FILE       write the generated program to FILE and exit" << endl <<
+            "Architecture:" << endl <<
+            "  -rs A,M,D     number of ADD/SUB, MULT and DIV stations (default 4,2,3," << endl <<
+            "                at most 999 in total)" << endl <<
+            "  -lat A,M,D    ADD/SUB, MULT and DIV latency (default 4,12,38)" << endl <<
+            "  -unified N    one pool of N (at most 999) stations shared by all op" << endl <<
+            "                classes; -rs then gives the functional units (ports)" << endl <<
+            "                of each class" << endl <<
+            "  -cap A,M,D    most stations ADD/SUB, MULT and DIV may hold in the" << endl <<
+            "                unified pool (0 = no cap, the default)" << endl <<
+            "  -smt T        T hardware threads, each on its own copy of the program," << endl <<
+            "                sharing the reservation stations (default 1, at most 64)" << endl <<
+            "  -issue P      SMT issue policy: rr (round-robin, default) or icount" << endl <<
+            "Checkpoints:" << endl <<
+            "  -save N FILE  save the machine state after cycle N to FILE and exit" << endl <<
+            "  -restore FILE resume from FILE; give the same -n/-seed/-t options as the" << endl <<
+            "                saved run, -rs/-lat fork it into a different architecture" << endl <<
+            "Sampling:" << endl <<
+            "  -sample P,W,U every P instructions run W warm-up and U measured" << endl <<
+            "                instructions in detail, fast-forward the rest" << endl <<
+            "Pipelined functional/timing split:" << endl <<
+            "  -pipeline     resolve values in a functional emulator thread that feeds" << endl <<
+            "                the timing model through a lock-free ring buffer" << endl <<
+            "  -produce NAME run only the functional emulator, into shared memory ring NAME" << endl <<
+            "  -consume NAME run only the timing model, from shared memory ring NAME" << endl <<
+            "Batch:" << endl <<
+            "  -batch FILE   run the program on every architecture in FILE at once," << endl <<
+            "                one 'A,M,D A,M,D' (stations, latency) per line" << endl <<
+            "  -threads T    spread the -batch architectures (or -cores) over T host threads" << endl <<
+            "Multicore:" << endl <<
+            "  -cores N      run N cores, each on its own copy of the program, in" << endl <<
+            "                parallel host threads (one per core unless -threads)" << endl <<
+            "  -quantum Q    cycles the cores run between barriers (default 100," << endl <<
+            "                at most 1000000)" << endl <<
+            "  -cdb W        cores share one CDB carrying W results per cycle" << endl <<
+            "Server:" << endl <<
+            "  -serve PATH   run jobs sent as option lines over Unix socket PATH on" << endl <<
+            "                -threads workers (default one per host CPU), answer" << endl <<
+            "                each with a JSON line; 'shutdown' stops the server" << endl <<
+            "Output:" << endl <<
+            "  -q            only print the final registers and a summary" << endl;
+}
 //#######################################################################